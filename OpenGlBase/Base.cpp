@@ -1,15 +1,29 @@
 #include "Base.h"
 #include "GLFW/glfw3.h"
+#include "Debug/Log.h"
 
 namespace Base
 {
-    void Init()
+    bool Init(const InitConfig& Config)
     {
-        glfwInit();
+        //does nothing if the application already started the log with its own config
+        Log::Init();
+
+        if (Config.Headless)
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
+        if (!glfwInit())
+        {
+            Log::Error<LogCategory::Window>("glfwInit failed{}", Config.Headless ? ", headless needs GLFW 3.4 built with the null platform" : "");
+            return false;
+        }
+
+        return true;
     }
 
     void Destroy()
     {
         glfwTerminate();
+        Log::Shutdown();
     }
 };
\ No newline at end of file
@@ -1,7 +1,15 @@
 #pragma once
 namespace Base
 {
-    void Init();
+    struct InitConfig
+    {
+        //GLFW's null platform, no display server needed. only Windows with a headless WindowBackend
+        //can be created after it
+        bool Headless = false;
+    };
+
+    //false when GLFW couldn't be initialized, no Window can be created then
+    bool Init(const InitConfig& Config = {});
     void Destroy();
 };
 
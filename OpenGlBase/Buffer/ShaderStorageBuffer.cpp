@@ -0,0 +1,67 @@
+#include "ShaderStorageBuffer.h"
+#include <cassert>
+
+namespace Base
+{
+    void InsertMemoryBarrier(GLbitfield Flags)
+    {
+        assert(GetGlExtensions().MemoryBarriers);
+        glMemoryBarrier(Flags);
+    }
+
+    ShaderStorageBuffer::ShaderStorageBuffer(std::size_t Size, const void* Data, GLenum Usage)
+        : Size(Size)
+    {
+        assert(GetGlExtensions().ShaderStorageBuffer);
+
+        glGenBuffers(1, &Buffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(Size), Data, Usage);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    ShaderStorageBuffer::~ShaderStorageBuffer()
+    {
+        glDeleteBuffers(1, &Buffer);
+    }
+
+    void ShaderStorageBuffer::Upload(const void* Data, std::size_t UploadSize, std::size_t Offset)
+    {
+        assert(Offset + UploadSize <= Size);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(Offset), static_cast<GLsizeiptr>(UploadSize), Data);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void ShaderStorageBuffer::Read(void* Data, std::size_t ReadSize, std::size_t Offset) const
+    {
+        assert(Offset + ReadSize <= Size);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(Offset), static_cast<GLsizeiptr>(ReadSize), Data);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void ShaderStorageBuffer::Bind(GLuint Binding) const
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Binding, Buffer);
+    }
+
+    void ShaderStorageBuffer::BindRange(GLuint Binding, std::size_t Offset, std::size_t RangeSize) const
+    {
+        assert(Offset + RangeSize <= Size);
+
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, Binding, Buffer, static_cast<GLintptr>(Offset), static_cast<GLsizeiptr>(RangeSize));
+    }
+
+    GLuint ShaderStorageBuffer::GetBuffer() const
+    {
+        return Buffer;
+    }
+
+    std::size_t ShaderStorageBuffer::GetSize() const
+    {
+        return Size;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+#include "../Gl/GlExtensions.h"
+
+namespace Base
+{
+    //the barrier bits grouped by how data written from a shader is going to be read next
+    enum MemoryBarrierFlags : GLbitfield
+    {
+        BarrierStorageBuffer = GL_SHADER_STORAGE_BARRIER_BIT,   //read by another dispatch or draw
+        BarrierVertexInput = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT,
+        BarrierIndirectCommand = GL_COMMAND_BARRIER_BIT,        //used as indirect draw or dispatch arguments
+        BarrierUniformBuffer = GL_UNIFORM_BARRIER_BIT,
+        BarrierBufferUpdate = GL_BUFFER_UPDATE_BARRIER_BIT,     //read back or copied with glGetBufferSubData and co
+        BarrierTextureFetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+        BarrierImageAccess = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+        BarrierAll = GL_ALL_BARRIER_BITS,
+    };
+
+    //makes incoherent writes from earlier dispatches and draws visible to the reads named in Flags
+    void InsertMemoryBarrier(GLbitfield Flags);
+
+    //a plain buffer for binding to shader storage block indices, it can also hold the arguments for
+    //ShaderProgram::DispatchIndirect
+    class ShaderStorageBuffer
+    {
+    public:
+        ShaderStorageBuffer(const ShaderStorageBuffer&) = delete;
+        ShaderStorageBuffer& operator=(const ShaderStorageBuffer&) = delete;
+
+        ShaderStorageBuffer(std::size_t Size, const void* Data = nullptr, GLenum Usage = GL_DYNAMIC_COPY);
+        ~ShaderStorageBuffer();
+
+        void Upload(const void* Data, std::size_t Size, std::size_t Offset = 0);
+
+        //issue BarrierBufferUpdate after the dispatch that wrote the data
+        void Read(void* Data, std::size_t Size, std::size_t Offset = 0) const;
+
+        template<typename T>
+        std::vector<T> Read(std::size_t Count, std::size_t Offset = 0) const
+        {
+            std::vector<T> Values(Count);
+            Read(Values.data(), Count * sizeof(T), Offset);
+            return Values;
+        }
+
+        void Bind(GLuint Binding) const;
+
+        //Offset has to be a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+        void BindRange(GLuint Binding, std::size_t Offset, std::size_t Size) const;
+
+        GLuint GetBuffer() const;
+        std::size_t GetSize() const;
+
+    private:
+        GLuint Buffer = 0;
+        std::size_t Size = 0;
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+
+//helpers for writing C++ structs that match a std140 uniform block byte for byte
+//
+//scalars, vec2, vec4, mat4, mat2x4 and mat3x4 already match when placed at their std140 offset,
+//a vec3 does too but the member after it may share its last 4 bytes so use explicit padding or
+//alignas(16) on whatever needs the next 16 byte boundary. matrices whose columns aren't vec4 and
+//arrays of anything smaller than a vec4 are padded out by std140 and need the types below
+//
+//check every member with STD140_ASSERT_OFFSET, GenerateStd140Struct writes those checks for you
+
+#define STD140_ASSERT_OFFSET(Struct, Member, Offset) \
+    static_assert(offsetof(Struct, Member) == (Offset), #Struct "::" #Member " is not at its std140 offset")
+
+#define STD140_ASSERT_SIZE(Struct, Size) \
+    static_assert(sizeof(Struct) == (Size), #Struct " does not match the size of its std140 block")
+
+namespace Base
+{
+    namespace Std140
+    {
+        //bools are 4 bytes in std140
+        using Bool = u32;
+
+        //array elements are rounded up to a multiple of 16 bytes
+        template<typename T, std::size_t Count>
+        struct Array
+        {
+            struct alignas(16) Element
+            {
+                T Value;
+            };
+
+            Element Elements[Count];
+
+            T& operator[](std::size_t Index) { return Elements[Index].Value; }
+            const T& operator[](std::size_t Index) const { return Elements[Index].Value; }
+        };
+
+        //a column major matrix whose columns are each padded to a vec4
+        template<int Columns, int Rows>
+        struct Matrix
+        {
+            glm::vec4 Column[Columns];
+
+            Matrix() = default;
+
+            Matrix(const glm::mat<Columns, Rows, f32>& Value)
+            {
+                *this = Value;
+            }
+
+            Matrix& operator=(const glm::mat<Columns, Rows, f32>& Value)
+            {
+                for (int i = 0; i < Columns; i++)
+                {
+                    Column[i] = glm::vec4(0.0f);
+                    for (int j = 0; j < Rows; j++)
+                        Column[i][j] = Value[i][j];
+                }
+
+                return *this;
+            }
+        };
+
+        using Mat2 = Matrix<2, 2>;
+        using Mat3 = Matrix<3, 3>;
+        using Mat2x3 = Matrix<2, 3>;
+        using Mat3x2 = Matrix<3, 2>;
+        using Mat4x2 = Matrix<4, 2>;
+        using Mat4x3 = Matrix<4, 3>;
+
+        static_assert(sizeof(glm::vec2) == 8 && sizeof(glm::vec3) == 12 && sizeof(glm::vec4) == 16, "glm vectors must be tightly packed");
+        static_assert(sizeof(glm::mat4) == 64 && sizeof(glm::mat2x4) == 32 && sizeof(glm::mat3x4) == 48, "glm matrices must be tightly packed");
+        static_assert(sizeof(Mat2) == 32 && sizeof(Mat3) == 48 && sizeof(Mat4x3) == 64, "std140 matrix padding is wrong");
+        static_assert(sizeof(Array<f32, 4>) == 64 && sizeof(Array<glm::vec4, 4>) == 64, "std140 array stride is wrong");
+    }
+}
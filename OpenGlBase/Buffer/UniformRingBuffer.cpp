@@ -0,0 +1,148 @@
+#include "UniformRingBuffer.h"
+#include "../Gl/GlExtensions.h"
+#include "../Debug/Log.h"
+#include <cassert>
+
+namespace Base
+{
+    UniformRingBuffer::UniformRingBuffer(const UniformRingBufferConfig& BufferConfig)
+        : Config(BufferConfig)
+    {
+        assert(Config.FramesInFlight > 0);
+
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Alignment);
+        if (Alignment <= 0)
+            Alignment = 256;
+
+        //keep every region starting on an aligned offset
+        Config.FrameSize = ((Config.FrameSize + Alignment - 1) / Alignment) * Alignment;
+
+        GLsizeiptr TotalSize = static_cast<GLsizeiptr>(Config.FrameSize) * Config.FramesInFlight;
+        Fences.resize(Config.FramesInFlight, nullptr);
+
+        glGenBuffers(1, &Buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+
+        if (GetGlExtensions().BufferStorage)
+        {
+            GLbitfield Flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_UNIFORM_BUFFER, TotalSize, nullptr, Flags);
+            Mapped = static_cast<u8*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, TotalSize, Flags));
+
+            if (!Mapped)
+                Log::Warning<LogCategory::Buffer>("Failed to persistently map uniform ring buffer, falling back to glBufferSubData");
+        }
+
+        if (!Mapped)
+        {
+            //immutable storage can't be respecified, start over with a fresh buffer
+            if (GetGlExtensions().BufferStorage)
+            {
+                glDeleteBuffers(1, &Buffer);
+                glGenBuffers(1, &Buffer);
+                glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+            }
+
+            glBufferData(GL_UNIFORM_BUFFER, TotalSize, nullptr, GL_STREAM_DRAW);
+            Staging.resize(TotalSize);
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    UniformRingBuffer::~UniformRingBuffer()
+    {
+        for (GLsync Fence : Fences)
+        {
+            if (Fence)
+                glDeleteSync(Fence);
+        }
+
+        if (Mapped)
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
+
+        glDeleteBuffers(1, &Buffer);
+    }
+
+    void UniformRingBuffer::NextFrame()
+    {
+        if (Fences[Frame])
+            glDeleteSync(Fences[Frame]);
+        Fences[Frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        Frame = (Frame + 1) % Config.FramesInFlight;
+        FrameStart = static_cast<std::size_t>(Frame) * Config.FrameSize;
+        Head = FrameStart;
+
+        GLsync Fence = Fences[Frame];
+        if (!Fence)
+            return;
+
+        //the first wait flushes so the fence is guaranteed to signal, after that just keep waiting
+        GLbitfield WaitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (true)
+        {
+            GLenum Result = glClientWaitSync(Fence, WaitFlags, 1000000);
+
+            if (Result == GL_ALREADY_SIGNALED || Result == GL_CONDITION_SATISFIED || Result == GL_WAIT_FAILED)
+                break;
+
+            WaitFlags = 0;
+        }
+
+        glDeleteSync(Fence);
+        Fences[Frame] = nullptr;
+    }
+
+    UniformAllocation UniformRingBuffer::Allocate(std::size_t Size)
+    {
+        std::size_t Offset = ((Head + Alignment - 1) / Alignment) * Alignment;
+
+        if (Offset + Size > FrameStart + Config.FrameSize)
+        {
+            Log::Error<LogCategory::Buffer>("Uniform ring buffer is out of space for this frame ({} bytes)", Config.FrameSize);
+            return {};
+        }
+
+        Head = Offset + Size;
+
+        UniformAllocation Allocation;
+        Allocation.Data = (Mapped ? Mapped : Staging.data()) + Offset;
+        Allocation.Offset = static_cast<GLintptr>(Offset);
+        Allocation.Size = static_cast<GLsizeiptr>(Size);
+        return Allocation;
+    }
+
+    void UniformRingBuffer::Bind(GLuint Binding, const UniformAllocation& Allocation)
+    {
+        assert(Allocation.IsValid());
+
+        if (!Mapped)
+        {
+            //the gpu has finished with this region so this can't stall on an in flight draw
+            glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+            glBufferSubData(GL_UNIFORM_BUFFER, Allocation.Offset, Allocation.Size, Staging.data() + Allocation.Offset);
+        }
+
+        glBindBufferRange(GL_UNIFORM_BUFFER, Binding, Buffer, Allocation.Offset, Allocation.Size);
+    }
+
+    bool UniformRingBuffer::IsPersistentlyMapped() const
+    {
+        return Mapped != nullptr;
+    }
+
+    GLuint UniformRingBuffer::GetBuffer() const
+    {
+        return Buffer;
+    }
+
+    std::size_t UniformRingBuffer::GetFrameUsage() const
+    {
+        return Head - FrameStart;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace Base
+{
+    struct UniformRingBufferConfig
+    {
+        //bytes available to a single frame, the buffer is FrameSize * FramesInFlight
+        u32 FrameSize = 1 << 20;
+        u32 FramesInFlight = 3;
+    };
+
+    //a block of uniform data written this frame, Data points at where the block's bytes go
+    struct UniformAllocation
+    {
+        void* Data = nullptr;
+        GLintptr Offset = 0;
+        GLsizeiptr Size = 0;
+
+        bool IsValid() const { return Data != nullptr; }
+    };
+
+    //one large uniform buffer split into per frame regions, every draw's blocks are sub-allocated from
+    //the current region and bound with glBindBufferRange so there's one memcpy per block instead of a
+    //glUniform call per member. a region is only written again once the fence placed after its frame
+    //has signalled
+    //
+    //with GL 4.4 / ARB_buffer_storage the buffer stays persistently mapped and Allocate hands out
+    //pointers straight into it, otherwise writes go to a staging copy and Bind uploads the block with
+    //glBufferSubData. either way a block has to be written before it's bound
+    class UniformRingBuffer
+    {
+    public:
+        UniformRingBuffer(const UniformRingBuffer&) = delete;
+        UniformRingBuffer& operator=(const UniformRingBuffer&) = delete;
+
+        UniformRingBuffer(const UniformRingBufferConfig& BufferConfig = {});
+        ~UniformRingBuffer();
+
+        //fences the frame that was just recorded and moves on to the next region, waiting if the gpu
+        //is still reading it, call once per frame for example through Window::AddTickCallback
+        void NextFrame();
+
+        //returns an invalid allocation when the frame's region is full
+        UniformAllocation Allocate(std::size_t Size);
+
+        template<typename T>
+        UniformAllocation Push(const T& Value)
+        {
+            UniformAllocation Allocation = Allocate(sizeof(T));
+
+            if (Allocation.IsValid())
+                std::memcpy(Allocation.Data, &Value, sizeof(T));
+
+            return Allocation;
+        }
+
+        void Bind(GLuint Binding, const UniformAllocation& Allocation);
+
+        template<typename T>
+        UniformAllocation PushAndBind(GLuint Binding, const T& Value)
+        {
+            UniformAllocation Allocation = Push(Value);
+
+            if (Allocation.IsValid())
+                Bind(Binding, Allocation);
+
+            return Allocation;
+        }
+
+        bool IsPersistentlyMapped() const;
+        GLuint GetBuffer() const;
+
+        //bytes allocated in the current frame, including alignment padding
+        std::size_t GetFrameUsage() const;
+
+    private:
+        UniformRingBufferConfig Config;
+
+        GLuint Buffer = 0;
+        u8* Mapped = nullptr;
+        std::vector<u8> Staging;
+        std::vector<GLsync> Fences;
+
+        GLint Alignment = 256;
+        u32 Frame = 0;
+        std::size_t FrameStart = 0;
+        std::size_t Head = 0;
+    };
+}
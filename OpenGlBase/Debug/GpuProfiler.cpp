@@ -0,0 +1,222 @@
+#include "GpuProfiler.h"
+#include "Log.h"
+#include <glad/glad.h>
+#include <cassert>
+#include <algorithm>
+
+namespace Base::GpuProfiler
+{
+    struct ZoneRecord
+    {
+        const char* Name;
+        u32 BeginQuery;
+        u32 EndQuery;
+        u32 Depth;
+    };
+
+    //one frame's queries, reused every FramesInFlight frames
+    struct FrameSlot
+    {
+        std::vector<GLuint> Queries;
+        std::vector<ZoneRecord> Zones;
+        u32 QueryCount = 0;
+        bool Pending = false;
+
+        //the calibration the frame was recorded with, a later one could move it across a frame boundary
+        i64 ClockOffset = 0;
+    };
+
+    //only ever touched from the thread the context is current on
+    static struct
+    {
+        bool Initialized = false;
+        GpuProfilerConfig Config;
+
+        std::vector<FrameSlot> Frames;
+        u32 Current = 0;
+        std::vector<u32> OpenZones;
+
+        std::vector<GLuint64> Results;
+        std::vector<GpuZoneTiming> LastFrame;
+        u32 DroppedFrames = 0;
+
+        //Profiler::GetTimestamp() minus the GPU's timestamp at the same moment
+        i64 ClockOffset = 0;
+        u32 FramesSinceCalibration = 0;
+
+        //the profiler has no way to remove a track, so it's added by the first Init and kept across Shutdown
+        u32 Track = 0;
+        bool HasTrack = false;
+    } State;
+
+    static void Calibrate()
+    {
+        //GL_TIMESTAMP through glGet is the GPU's time once every earlier command has reached it, not
+        //when it's executed, so there's no stall. the CPU clock is read either side and averaged
+        GLint64 GpuTime = 0;
+        u64 Before = Profiler::GetTimestamp();
+        glGetInteger64v(GL_TIMESTAMP, &GpuTime);
+        u64 After = Profiler::GetTimestamp();
+
+        State.ClockOffset = static_cast<i64>(Before + (After - Before) / 2) - static_cast<i64>(GpuTime);
+        State.FramesSinceCalibration = 0;
+    }
+
+    bool Init(const GpuProfilerConfig& Config)
+    {
+        if (State.Initialized)
+            Shutdown();
+
+        //timer queries are core since 3.3
+        if (!GLAD_GL_VERSION_3_3)
+        {
+            Log::Warning<LogCategory::Profiler>("GPU profiling needs GL 3.3, timer queries aren't available");
+            return false;
+        }
+
+        State.Config = Config;
+        State.Config.FramesInFlight = std::max(Config.FramesInFlight, 2u);
+
+        State.Frames.resize(State.Config.FramesInFlight);
+        for (FrameSlot& Frame : State.Frames)
+        {
+            Frame.Queries.resize(static_cast<std::size_t>(State.Config.MaxZonesPerFrame) * 2);
+            glGenQueries(static_cast<GLsizei>(Frame.Queries.size()), Frame.Queries.data());
+            Frame.Zones.reserve(State.Config.MaxZonesPerFrame);
+        }
+
+        State.Results.resize(static_cast<std::size_t>(State.Config.MaxZonesPerFrame) * 2);
+        State.LastFrame.reserve(State.Config.MaxZonesPerFrame);
+        State.Current = 0;
+        State.DroppedFrames = 0;
+
+        if (!State.HasTrack)
+        {
+            State.Track = Profiler::AddTrack("GPU");
+            State.HasTrack = true;
+        }
+
+        Calibrate();
+
+        State.Initialized = true;
+        return true;
+    }
+
+    void Shutdown()
+    {
+        for (FrameSlot& Frame : State.Frames)
+            glDeleteQueries(static_cast<GLsizei>(Frame.Queries.size()), Frame.Queries.data());
+
+        State.Frames.clear();
+        State.OpenZones.clear();
+        State.LastFrame.clear();
+        State.Initialized = false;
+    }
+
+    bool IsInitialized()
+    {
+        return State.Initialized;
+    }
+
+    bool BeginZone(const char* Name)
+    {
+        if (!State.Initialized)
+            return false;
+
+        FrameSlot& Frame = State.Frames[State.Current];
+
+        //room for this zone's begin and end plus the ends of every zone that is already open
+        if (Frame.Queries.size() - Frame.QueryCount < State.OpenZones.size() + 2)
+            return false;
+
+        glQueryCounter(Frame.Queries[Frame.QueryCount], GL_TIMESTAMP);
+
+        State.OpenZones.push_back(static_cast<u32>(Frame.Zones.size()));
+        Frame.Zones.push_back({ Name, Frame.QueryCount++, 0, static_cast<u32>(State.OpenZones.size() - 1) });
+        return true;
+    }
+
+    void EndZone()
+    {
+        FrameSlot& Frame = State.Frames[State.Current];
+
+        glQueryCounter(Frame.Queries[Frame.QueryCount], GL_TIMESTAMP);
+
+        Frame.Zones[State.OpenZones.back()].EndQuery = Frame.QueryCount++;
+        State.OpenZones.pop_back();
+    }
+
+    static bool ReadFrame(FrameSlot& Frame)
+    {
+        //timestamps are written in submission order so this is normally only the last one, but
+        //nothing in the spec promises that
+        for (u32 i = Frame.QueryCount; i-- > 0;)
+        {
+            GLint Available = 0;
+            glGetQueryObjectiv(Frame.Queries[i], GL_QUERY_RESULT_AVAILABLE, &Available);
+            if (!Available)
+                return false;
+        }
+
+        for (u32 i = 0; i < Frame.QueryCount; i++)
+            glGetQueryObjectui64v(Frame.Queries[i], GL_QUERY_RESULT, &State.Results[i]);
+
+        State.LastFrame.clear();
+        for (const ZoneRecord& Zone : Frame.Zones)
+        {
+            GLuint64 Begin = State.Results[Zone.BeginQuery];
+            GLuint64 End = std::max(State.Results[Zone.EndQuery], Begin);
+
+            State.LastFrame.push_back({ Zone.Name, Zone.Depth, static_cast<f64>(End - Begin) / 1e6 });
+            Profiler::AddZone(State.Track, Zone.Name, static_cast<u64>(static_cast<i64>(Begin) + Frame.ClockOffset), static_cast<u64>(static_cast<i64>(End) + Frame.ClockOffset));
+        }
+
+        Frame.Pending = false;
+        return true;
+    }
+
+    void EndFrame()
+    {
+        if (!State.Initialized)
+            return;
+
+        assert(State.OpenZones.empty() && "GPU zones can't span a frame boundary");
+
+        FrameSlot& Ended = State.Frames[State.Current];
+        Ended.Pending = Ended.QueryCount > 0;
+        Ended.ClockOffset = State.ClockOffset;
+
+        //oldest first so LastFrame ends up as the newest frame that is done, a frame that isn't ready
+        //yet means the ones after it aren't either
+        u32 Count = State.Config.FramesInFlight;
+        for (u32 i = 1; i <= Count; i++)
+        {
+            FrameSlot& Frame = State.Frames[(State.Current + i) % Count];
+            if (Frame.Pending && !ReadFrame(Frame))
+                break;
+        }
+
+        State.Current = (State.Current + 1) % Count;
+
+        FrameSlot& Next = State.Frames[State.Current];
+        if (Next.Pending)
+            State.DroppedFrames++;
+
+        Next.Pending = false;
+        Next.QueryCount = 0;
+        Next.Zones.clear();
+
+        if (++State.FramesSinceCalibration >= State.Config.CalibrationInterval)
+            Calibrate();
+    }
+
+    const std::vector<GpuZoneTiming>& GetLastFrame()
+    {
+        return State.LastFrame;
+    }
+
+    u32 GetDroppedFrames()
+    {
+        return State.DroppedFrames;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+
+#include "Profiler.h"
+
+#if PROFILER_ENABLED
+    //names have to be string literals, zones can nest but must not span a GpuProfiler::EndFrame
+    #define GPU_PROFILE_SCOPE(Name) ::Base::GpuZone PROFILE_CONCAT(GpuZone, __LINE__)(Name)
+#else
+    #define GPU_PROFILE_SCOPE(Name) ((void)0)
+#endif
+
+namespace Base
+{
+    struct GpuProfilerConfig
+    {
+        //frames of timestamp queries kept in flight. results are read back once the GPU has written
+        //them, a frame still waiting when its queries come round again is dropped instead of stalling
+        u32 FramesInFlight = 4;
+
+        //each zone takes two queries, zones past this in a frame aren't recorded
+        u32 MaxZonesPerFrame = 128;
+
+        //frames between matching the GPU clock against Profiler::GetTimestamp again, the two drift apart
+        u32 CalibrationInterval = 240;
+    };
+
+    struct GpuZoneTiming
+    {
+        const char* Name;
+        u32 Depth;
+        f64 Milliseconds;
+    };
+
+    //GPU zones are glQueryCounter(GL_TIMESTAMP) pairs. finished frames go to the "GPU" track of the
+    //profiler capture, so passes line up with the CPU zones that submitted them
+    namespace GpuProfiler
+    {
+        //needs the context it will be used with to be current, false if timer queries aren't supported
+        bool Init(const GpuProfilerConfig& Config = {});
+        void Shutdown();
+        bool IsInitialized();
+
+        //closes the frame and reads back every earlier frame whose queries are done, never waits on the GPU.
+        //Window::Tick calls it before swapping buffers
+        void EndFrame();
+
+        //zones of the newest frame that has been read back, in the order they began
+        const std::vector<GpuZoneTiming>& GetLastFrame();
+
+        //frames whose results didn't arrive within FramesInFlight frames
+        u32 GetDroppedFrames();
+
+        //what GpuZone uses, EndZone only for a BeginZone that returned true
+        bool BeginZone(const char* Name);
+        void EndZone();
+    }
+
+    class GpuZone
+    {
+    public:
+        explicit GpuZone(const char* Name)
+            : Recorded(GpuProfiler::BeginZone(Name))
+        {
+        }
+
+        ~GpuZone()
+        {
+            if (Recorded)
+                GpuProfiler::EndZone();
+        }
+
+        GpuZone(const GpuZone&) = delete;
+        GpuZone& operator=(const GpuZone&) = delete;
+
+    private:
+        bool Recorded;
+    };
+}
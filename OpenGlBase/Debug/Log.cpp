@@ -0,0 +1,485 @@
+#include "Log.h"
+#include "LogFormat.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace Base::Log
+{
+    //every record is a header followed by the encoded arguments, padded so the next header stays aligned.
+    //Format points at the string literal the message was logged with
+    struct RecordHeader
+    {
+        u64 Timestamp;
+        const char* Format;
+        u32 FormatLength;
+        u32 Length;
+        LogLevel Level;
+        LogCategory Category;
+        u16 Flags;
+    };
+
+    //the payload in the ring is a std::string* owning the real one, for records too big to copy in
+    static constexpr u16 RecordOnHeap = 1;
+
+    static constexpr u64 RecordAlignment = alignof(RecordHeader);
+
+    //single producer single consumer, the owning thread only moves Head and the writer only moves Tail.
+    //both only ever grow and wrap through Mask, so Head - Tail is always the number of bytes in use
+    struct Ring
+    {
+        std::unique_ptr<u8[]> Data;
+        u64 Capacity = 0;
+        u64 Mask = 0;
+
+        alignas(64) std::atomic<u64> Head = 0;
+        alignas(64) std::atomic<u64> Tail = 0;
+
+        std::atomic<u32> Dropped = 0;
+
+        //set by the owning thread around a write, Shutdown waits for it to clear before the last drain
+        std::atomic<bool> Writing = false;
+
+        //set when the owning thread exits, the writer frees the ring once it is empty
+        std::atomic<bool> Retired = false;
+
+        void CopyIn(u64 Position, const void* Source, u64 Size)
+        {
+            u64 Offset = Position & Mask;
+            u64 First = std::min(Size, Capacity - Offset);
+            std::memcpy(Data.get() + Offset, Source, First);
+            std::memcpy(Data.get(), static_cast<const u8*>(Source) + First, Size - First);
+        }
+
+        void CopyOut(u64 Position, void* Destination, u64 Size) const
+        {
+            u64 Offset = Position & Mask;
+            u64 First = std::min(Size, Capacity - Offset);
+            std::memcpy(Destination, Data.get() + Offset, First);
+            std::memcpy(static_cast<u8*>(Destination) + First, Data.get(), Size - First);
+        }
+    };
+
+    struct PendingRecord
+    {
+        RecordHeader Header;
+        std::size_t PayloadOffset;
+    };
+
+    struct LogState
+    {
+        LogConfig Config;
+        std::atomic<bool> Running = false;
+        std::FILE* File = nullptr;
+
+        std::mutex RingMutex;
+        std::vector<std::shared_ptr<Ring>> Rings;
+
+        std::thread Writer;
+        std::mutex WakeMutex;
+        std::condition_variable WakeCondition;
+        std::condition_variable FlushedCondition;
+        u64 FlushRequested = 0;
+        u64 FlushCompleted = 0;
+        bool StopRequested = false;
+
+        //only used by the fallback path before Init and after Shutdown
+        std::mutex DirectMutex;
+
+        //only touched by the writer thread
+        std::vector<std::shared_ptr<Ring>> DrainRings;
+        std::vector<PendingRecord> Records;
+        std::string Payloads;
+        std::string Output;
+        std::string BinaryOutput;
+        std::string Message;
+        std::vector<DecodedArgument> Arguments;
+        BinaryLogWriter Binary;
+
+        //a thread that is still joinable at exit would terminate the program
+        ~LogState()
+        {
+            Shutdown();
+        }
+    };
+
+    static LogState State;
+    static const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+    static u64 GetTimestamp()
+    {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime).count());
+    }
+
+    //owned by the thread through a thread_local so exiting threads hand their ring back to the writer
+    struct ThreadRing
+    {
+        std::shared_ptr<Ring> Instance;
+
+        ~ThreadRing()
+        {
+            if (Instance)
+                Instance->Retired.store(true, std::memory_order_release);
+        }
+    };
+
+    static Ring& GetRing()
+    {
+        thread_local ThreadRing Local;
+
+        if (!Local.Instance)
+        {
+            u64 Capacity = 1024;
+            while (Capacity < State.Config.RingSize)
+                Capacity <<= 1;
+
+            Local.Instance = std::make_shared<Ring>();
+            Local.Instance->Data = std::make_unique<u8[]>(Capacity);
+            Local.Instance->Capacity = Capacity;
+            Local.Instance->Mask = Capacity - 1;
+
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            State.Rings.push_back(Local.Instance);
+        }
+
+        return *Local.Instance;
+    }
+
+    static void AppendRecordText(std::string& Output, std::string& Message, std::vector<DecodedArgument>& Arguments, const RecordHeader& Header, std::string_view Payload)
+    {
+        Message.clear();
+
+        if (DecodeArguments(Payload, Arguments))
+            FormatMessage(Message, std::string_view(Header.Format, Header.FormatLength), Arguments);
+        else
+            Message = "(damaged log record)";
+
+        AppendLine(Output, Header.Timestamp, Header.Level, Header.Category, Message);
+    }
+
+    static void WriteDirect(const RecordHeader& Header, std::string_view Payload)
+    {
+        std::string Output;
+        std::string Message;
+        std::vector<DecodedArgument> Arguments;
+        AppendRecordText(Output, Message, Arguments, Header, Payload);
+
+        std::lock_guard<std::mutex> Lock(State.DirectMutex);
+        std::fwrite(Output.data(), 1, Output.size(), stderr);
+    }
+
+    static bool IsBinaryFile()
+    {
+        return State.File && State.Config.FileFormat == LogFileFormat::Binary;
+    }
+
+    static void WriteOutput()
+    {
+        if (!State.Output.empty() && State.Config.WriteToStderr)
+            std::fwrite(State.Output.data(), 1, State.Output.size(), stderr);
+
+        const std::string& FileOutput = IsBinaryFile() ? State.BinaryOutput : State.Output;
+        if (!FileOutput.empty() && State.File)
+        {
+            std::fwrite(FileOutput.data(), 1, FileOutput.size(), State.File);
+            std::fflush(State.File);
+        }
+    }
+
+    static void DrainRing(Ring& Source)
+    {
+        u64 Tail = Source.Tail.load(std::memory_order_relaxed);
+        u64 Head = Source.Head.load(std::memory_order_acquire);
+
+        while (Tail != Head)
+        {
+            PendingRecord& Record = State.Records.emplace_back();
+            Source.CopyOut(Tail, &Record.Header, sizeof(RecordHeader));
+
+            u64 RecordSize = (sizeof(RecordHeader) + Record.Header.Length + RecordAlignment - 1) & ~(RecordAlignment - 1);
+            Record.PayloadOffset = State.Payloads.size();
+
+            if (Record.Header.Flags & RecordOnHeap)
+            {
+                std::string* Payload = nullptr;
+                Source.CopyOut(Tail + sizeof(RecordHeader), &Payload, sizeof(Payload));
+
+                State.Payloads += *Payload;
+                Record.Header.Length = static_cast<u32>(Payload->size());
+                delete Payload;
+            }
+            else
+            {
+                State.Payloads.resize(Record.PayloadOffset + Record.Header.Length);
+                Source.CopyOut(Tail + sizeof(RecordHeader), State.Payloads.data() + Record.PayloadOffset, Record.Header.Length);
+            }
+
+            Tail += RecordSize;
+        }
+
+        Source.Tail.store(Tail, std::memory_order_release);
+
+        u32 Dropped = Source.Dropped.exchange(0, std::memory_order_relaxed);
+        if (Dropped > 0)
+        {
+            static constexpr std::string_view DroppedFormat = "Log ring was full, dropped {} messages";
+
+            PendingRecord& Record = State.Records.emplace_back();
+            Record.Header = { GetTimestamp(), DroppedFormat.data(), static_cast<u32>(DroppedFormat.size()), 0, LogLevel::Warning, LogCategory::General, 0 };
+            Record.PayloadOffset = State.Payloads.size();
+
+            EncodeArgument(State.Payloads, Dropped);
+            Record.Header.Length = static_cast<u32>(State.Payloads.size() - Record.PayloadOffset);
+        }
+    }
+
+    static void Drain()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            State.DrainRings = State.Rings;
+        }
+
+        State.Records.clear();
+        State.Payloads.clear();
+        State.Output.clear();
+        State.BinaryOutput.clear();
+
+        bool HasRetired = false;
+        for (const std::shared_ptr<Ring>& Source : State.DrainRings)
+        {
+            //read before draining so a thread that exits afterwards keeps its ring until the next pass
+            bool Retired = Source->Retired.load(std::memory_order_acquire);
+            DrainRing(*Source);
+            HasRetired |= Retired;
+        }
+
+        //rings are drained one after another, sorting puts messages from different threads back in order
+        std::stable_sort(State.Records.begin(), State.Records.end(), [](const PendingRecord& A, const PendingRecord& B) { return A.Header.Timestamp < B.Header.Timestamp; });
+
+        //text is only built when something reads it, a binary log with stderr off never formats at all
+        bool NeedsText = State.Config.WriteToStderr || (State.File && !IsBinaryFile());
+
+        for (const PendingRecord& Record : State.Records)
+        {
+            std::string_view Payload = std::string_view(State.Payloads).substr(Record.PayloadOffset, Record.Header.Length);
+
+            if (NeedsText)
+                AppendRecordText(State.Output, State.Message, State.Arguments, Record.Header, Payload);
+
+            if (IsBinaryFile())
+                State.Binary.WriteMessage(State.BinaryOutput, Record.Header.Timestamp, Record.Header.Level, Record.Header.Category, std::string_view(Record.Header.Format, Record.Header.FormatLength), Payload);
+        }
+
+        WriteOutput();
+
+        State.DrainRings.clear();
+
+        if (HasRetired)
+        {
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            std::erase_if(State.Rings, [](const std::shared_ptr<Ring>& Source)
+            {
+                return Source->Retired.load(std::memory_order_acquire) && Source->Head.load(std::memory_order_acquire) == Source->Tail.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    static void WriterThread()
+    {
+        std::unique_lock<std::mutex> Lock(State.WakeMutex);
+
+        while (true)
+        {
+            State.WakeCondition.wait_for(Lock, std::chrono::milliseconds(State.Config.FlushIntervalMs), []
+            {
+                return State.StopRequested || State.FlushRequested != State.FlushCompleted;
+            });
+
+            bool Stop = State.StopRequested;
+            u64 Requested = State.FlushRequested;
+
+            Lock.unlock();
+            Drain();
+            Lock.lock();
+
+            State.FlushCompleted = Requested;
+            State.FlushedCondition.notify_all();
+
+            if (Stop)
+                break;
+        }
+    }
+
+    void Init(const LogConfig& Config)
+    {
+        if (State.Running.load(std::memory_order_acquire))
+            return;
+
+        State.Config = Config;
+
+        if (Config.FilePath)
+        {
+            State.File = std::fopen(Config.FilePath, Config.FileFormat == LogFileFormat::Binary ? "wb" : "w");
+            if (!State.File)
+                std::fprintf(stderr, "Failed to open log file %s\n", Config.FilePath);
+        }
+
+        if (IsBinaryFile())
+        {
+            std::string Header;
+            State.Binary.WriteHeader(Header);
+            std::fwrite(Header.data(), 1, Header.size(), State.File);
+        }
+
+        State.StopRequested = false;
+        State.Writer = std::thread(WriterThread);
+        State.Running.store(true, std::memory_order_release);
+    }
+
+    void Shutdown()
+    {
+        if (!State.Running.load(std::memory_order_acquire))
+            return;
+
+        //anything logged from here on goes straight to stderr. a thread that saw Running before the store
+        //may still be copying into its ring, wait for those so the last drain picks up everything
+        State.Running.store(false, std::memory_order_seq_cst);
+
+        {
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            for (const std::shared_ptr<Ring>& Source : State.Rings)
+            {
+                while (Source->Writing.load(std::memory_order_seq_cst))
+                    std::this_thread::yield();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock(State.WakeMutex);
+            State.StopRequested = true;
+        }
+
+        State.WakeCondition.notify_one();
+        State.Writer.join();
+
+        if (State.File)
+        {
+            std::fclose(State.File);
+            State.File = nullptr;
+        }
+    }
+
+    void Flush()
+    {
+        if (!State.Running.load(std::memory_order_acquire))
+            return;
+
+        std::unique_lock<std::mutex> Lock(State.WakeMutex);
+        u64 Target = ++State.FlushRequested;
+
+        State.WakeCondition.notify_one();
+        State.FlushedCondition.wait(Lock, [&] { return State.FlushCompleted >= Target || State.StopRequested; });
+    }
+
+    const char* GetLevelName(LogLevel Level)
+    {
+        switch (Level)
+        {
+            case(LogLevel::Trace): return "Trace";
+            case(LogLevel::Info): return "Info";
+            case(LogLevel::Warning): return "Warning";
+            case(LogLevel::Error): return "Error";
+        }
+
+        return "Unknown";
+    }
+
+    const char* GetCategoryName(LogCategory Category)
+    {
+        switch (Category)
+        {
+            case(LogCategory::General): return "General";
+            case(LogCategory::Gl): return "Gl";
+            case(LogCategory::Shader): return "Shader";
+            case(LogCategory::Buffer): return "Buffer";
+            case(LogCategory::FileSystem): return "FileSystem";
+            case(LogCategory::Window): return "Window";
+            case(LogCategory::Profiler): return "Profiler";
+            case(LogCategory::Count): break;
+        }
+
+        return "Unknown";
+    }
+
+    std::string& GetThreadBuffer()
+    {
+        thread_local std::string Buffer;
+        return Buffer;
+    }
+
+    void Write(LogLevel Level, LogCategory Category, std::string_view Format, std::string_view Payload)
+    {
+        RecordHeader Header = { GetTimestamp(), Format.data(), static_cast<u32>(Format.size()), static_cast<u32>(Payload.size()), Level, Category, 0 };
+
+        if (!State.Running.load(std::memory_order_acquire))
+        {
+            WriteDirect(Header, Payload);
+            return;
+        }
+
+        Ring& Target = GetRing();
+
+        //pairs with Shutdown, either this sees Running cleared or Shutdown sees Writing set and waits
+        Target.Writing.store(true, std::memory_order_seq_cst);
+
+        if (!State.Running.load(std::memory_order_seq_cst))
+        {
+            Target.Writing.store(false, std::memory_order_release);
+            WriteDirect(Header, Payload);
+            return;
+        }
+
+        //a record can take at most a quarter of the ring, anything bigger (a long driver info log) is rare
+        //enough to be copied to the heap and only have its pointer go through the ring, so it still reaches
+        //every output in order
+        std::string* HeapPayload = nullptr;
+        const void* RingPayload = Payload.data();
+
+        if (sizeof(RecordHeader) + Payload.size() > Target.Capacity / 4)
+        {
+            HeapPayload = new std::string(Payload);
+            RingPayload = &HeapPayload;
+            Header.Length = sizeof(HeapPayload);
+            Header.Flags = RecordOnHeap;
+        }
+
+        u64 RecordSize = (sizeof(RecordHeader) + Header.Length + RecordAlignment - 1) & ~(RecordAlignment - 1);
+
+        u64 Head = Target.Head.load(std::memory_order_relaxed);
+        u64 Tail = Target.Tail.load(std::memory_order_acquire);
+
+        if (Target.Capacity - (Head - Tail) < RecordSize)
+        {
+            Target.Dropped.fetch_add(1, std::memory_order_relaxed);
+            Target.Writing.store(false, std::memory_order_release);
+            delete HeapPayload;
+            return;
+        }
+
+        Target.CopyIn(Head, &Header, sizeof(RecordHeader));
+        Target.CopyIn(Head + sizeof(RecordHeader), RingPayload, Header.Length);
+        Target.Head.store(Head + RecordSize, std::memory_order_release);
+        Target.Writing.store(false, std::memory_order_release);
+
+        if (Level == LogLevel::Error && State.Config.FlushOnError)
+            Flush();
+    }
+}
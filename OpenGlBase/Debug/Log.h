@@ -0,0 +1,282 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <charconv>
+#include <cstdint>
+
+//compile time filtering, anything below LOG_MIN_LEVEL or in a category that isn't in LOG_CATEGORY_MASK
+//compiles down to nothing, not even the formatting. both can be overridden from the build
+#ifndef LOG_MIN_LEVEL
+    #ifdef NDEBUG
+        #define LOG_MIN_LEVEL 1
+    #else
+        #define LOG_MIN_LEVEL 0
+    #endif
+#endif
+
+#ifndef LOG_CATEGORY_MASK
+    #define LOG_CATEGORY_MASK 0xFFFFFFFFu
+#endif
+
+namespace Base
+{
+    enum class LogLevel : u8
+    {
+        Trace,
+        Info,
+        Warning,
+        Error
+    };
+
+    enum class LogCategory : u8
+    {
+        General,
+        Gl,
+        Shader,
+        Buffer,
+        FileSystem,
+        Window,
+        Profiler,
+        Count
+    };
+
+    enum class LogFileFormat : u8
+    {
+        Text,
+
+        //format string ids and raw arguments, several times smaller than the text on long runs.
+        //Tools/LogDecode turns it back into text
+        Binary
+    };
+
+    struct LogConfig
+    {
+        //nullptr to only write to stderr
+        const char* FilePath = nullptr;
+        LogFileFormat FileFormat = LogFileFormat::Text;
+
+        //always text, formatted on the writer thread
+        bool WriteToStderr = true;
+
+        //bytes per producer thread, rounded up to a power of two. messages that don't fit are dropped
+        //and counted rather than blocking the thread that logged them
+        u32 RingSize = 1 << 16;
+
+        //how often the writer thread wakes up to drain the rings
+        u32 FlushIntervalMs = 5;
+
+        //errors are usually followed by an assert, so by default they wait until they have been written
+        bool FlushOnError = true;
+    };
+
+    namespace Log
+    {
+        //starts the writer thread, until then and after Shutdown messages are written straight to stderr
+        void Init(const LogConfig& Config = {});
+        void Shutdown();
+
+        //blocks until everything logged before the call has been written
+        void Flush();
+
+        const char* GetLevelName(LogLevel Level);
+        const char* GetCategoryName(LogCategory Category);
+
+        constexpr bool IsEnabled(LogLevel Level, LogCategory Category)
+        {
+            //through a variable, comparing the level against a literal 0 trips -Wtype-limits
+            constexpr u32 MinLevel = LOG_MIN_LEVEL;
+            return static_cast<u32>(Level) >= MinLevel && (LOG_CATEGORY_MASK & (1u << static_cast<u32>(Category))) != 0;
+        }
+
+        //messages are stored as the format string's address and the raw arguments, the text is only
+        //built on the writer thread or by the LogDecode tool. arithmetic types, enums, strings and pointers
+        //are encoded as they are, anything else needs a FormatArgument overload and is formatted on the
+        //calling thread instead
+        enum class ArgumentType : u8
+        {
+            Int,
+            UInt,
+            F32,
+            F64,
+            Bool,
+            Char,
+            String,
+            Pointer
+        };
+
+        inline void WriteVarint(std::string& Output, u64 Value)
+        {
+            while (Value >= 0x80)
+            {
+                Output += static_cast<char>(Value | 0x80);
+                Value >>= 7;
+            }
+            Output += static_cast<char>(Value);
+        }
+
+        inline void EncodeTag(std::string& Payload, ArgumentType Type)
+        {
+            Payload += static_cast<char>(Type);
+        }
+
+        inline void EncodeString(std::string& Payload, std::string_view Value)
+        {
+            EncodeTag(Payload, ArgumentType::String);
+            WriteVarint(Payload, Value.size());
+            Payload += Value;
+        }
+
+        template<glm::length_t L, typename T, glm::qualifier Q>
+        void FormatArgument(std::string& Output, const glm::vec<L, T, Q>& Value)
+        {
+            char Buffer[32];
+            Output += '(';
+            for (glm::length_t i = 0; i < L; i++)
+            {
+                if (i > 0)
+                    Output += ", ";
+
+                std::to_chars_result Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value[i]);
+                Output.append(Buffer, Result.ptr);
+            }
+            Output += ')';
+        }
+
+        template<typename T>
+        void EncodeArgument(std::string& Payload, const T& Value)
+        {
+            using Type = std::decay_t<T>;
+
+            if constexpr (std::is_same_v<Type, bool>)
+            {
+                EncodeTag(Payload, ArgumentType::Bool);
+                Payload += static_cast<char>(Value);
+            }
+            else if constexpr (std::is_same_v<Type, char>)
+            {
+                EncodeTag(Payload, ArgumentType::Char);
+                Payload += Value;
+            }
+            else if constexpr (std::is_enum_v<Type>)
+            {
+                EncodeArgument(Payload, static_cast<std::underlying_type_t<Type>>(Value));
+            }
+            else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+            {
+                //zigzag so small negative numbers stay small
+                i64 Signed = static_cast<i64>(Value);
+                EncodeTag(Payload, ArgumentType::Int);
+                WriteVarint(Payload, (static_cast<u64>(Signed) << 1) ^ static_cast<u64>(Signed >> 63));
+            }
+            else if constexpr (std::is_integral_v<Type>)
+            {
+                EncodeTag(Payload, ArgumentType::UInt);
+                WriteVarint(Payload, static_cast<u64>(Value));
+            }
+            else if constexpr (std::is_same_v<Type, f32>)
+            {
+                EncodeTag(Payload, ArgumentType::F32);
+                Payload.append(reinterpret_cast<const char*>(&Value), sizeof(f32));
+            }
+            else if constexpr (std::is_floating_point_v<Type>)
+            {
+                f64 Double = static_cast<f64>(Value);
+                EncodeTag(Payload, ArgumentType::F64);
+                Payload.append(reinterpret_cast<const char*>(&Double), sizeof(f64));
+            }
+            else if constexpr (std::is_array_v<T>)
+            {
+                EncodeString(Payload, std::string_view(Value));
+            }
+            else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+            {
+                EncodeString(Payload, Value ? std::string_view(Value) : std::string_view("(null)"));
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            {
+                EncodeString(Payload, Value);
+            }
+            else if constexpr (std::is_pointer_v<Type>)
+            {
+                EncodeTag(Payload, ArgumentType::Pointer);
+                WriteVarint(Payload, reinterpret_cast<std::uintptr_t>(Value));
+            }
+            else
+            {
+                std::string Text;
+                FormatArgument(Text, Value);
+                EncodeString(Payload, Text);
+            }
+        }
+
+        //counts {} the same way the decoder replaces them, {{ and }} are literal braces
+        constexpr std::size_t CountPlaceholders(std::string_view Format)
+        {
+            std::size_t Count = 0;
+            for (std::size_t i = 0; i + 1 < Format.size(); i++)
+            {
+                if (Format[i] == '{' && Format[i + 1] == '}')
+                {
+                    Count++;
+                    i++;
+                }
+                else if ((Format[i] == '{' || Format[i] == '}') && Format[i + 1] == Format[i])
+                {
+                    i++;
+                }
+            }
+            return Count;
+        }
+
+        //not constexpr, calling it from the consteval constructor below is what turns a mismatch into a compile error
+        void FormatPlaceholderCountMismatch();
+
+        //format strings have to be literals, only their address is kept until the writer formats the message
+        template<typename... Args>
+        struct FormatString
+        {
+            consteval FormatString(const char* Format)
+                : Text(Format)
+            {
+                if (CountPlaceholders(Text) != sizeof...(Args))
+                    FormatPlaceholderCountMismatch();
+            }
+
+            std::string_view Text;
+        };
+
+        //reused per thread so encoding doesn't allocate once it has grown
+        std::string& GetThreadBuffer();
+
+        //copies the message into the calling thread's ring, never takes a lock or waits for the writer
+        void Write(LogLevel Level, LogCategory Category, std::string_view Format, std::string_view Payload);
+
+        template<LogLevel Level, LogCategory Category, typename... Args>
+        void Print(std::string_view Format, const Args&... Arguments)
+        {
+            if constexpr (IsEnabled(Level, Category))
+            {
+                std::string& Payload = GetThreadBuffer();
+                Payload.clear();
+
+                (EncodeArgument(Payload, Arguments), ...);
+
+                Write(Level, Category, Format, Payload);
+            }
+        }
+
+        //Log::Warning<LogCategory::Shader>("Failed to read {}", Path), the category defaults to General
+        template<LogCategory Category = LogCategory::General, typename... Args>
+        void Trace(FormatString<std::type_identity_t<Args>...> Format, const Args&... Arguments) { Print<LogLevel::Trace, Category>(Format.Text, Arguments...); }
+
+        template<LogCategory Category = LogCategory::General, typename... Args>
+        void Info(FormatString<std::type_identity_t<Args>...> Format, const Args&... Arguments) { Print<LogLevel::Info, Category>(Format.Text, Arguments...); }
+
+        template<LogCategory Category = LogCategory::General, typename... Args>
+        void Warning(FormatString<std::type_identity_t<Args>...> Format, const Args&... Arguments) { Print<LogLevel::Warning, Category>(Format.Text, Arguments...); }
+
+        template<LogCategory Category = LogCategory::General, typename... Args>
+        void Error(FormatString<std::type_identity_t<Args>...> Format, const Args&... Arguments) { Print<LogLevel::Error, Category>(Format.Text, Arguments...); }
+    }
+}
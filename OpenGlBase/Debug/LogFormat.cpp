@@ -0,0 +1,280 @@
+#include "LogFormat.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+namespace Base::Log
+{
+    bool ReadVarint(std::string_view Data, std::size_t& Offset, u64& Value)
+    {
+        Value = 0;
+
+        for (u32 Shift = 0; Shift < 64; Shift += 7)
+        {
+            if (Offset >= Data.size())
+                return false;
+
+            u8 Byte = static_cast<u8>(Data[Offset++]);
+            Value |= static_cast<u64>(Byte & 0x7F) << Shift;
+
+            if ((Byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static bool ReadBytes(std::string_view Data, std::size_t& Offset, void* Destination, std::size_t Size)
+    {
+        if (Size > Data.size() - Offset)
+            return false;
+
+        std::memcpy(Destination, Data.data() + Offset, Size);
+        Offset += Size;
+        return true;
+    }
+
+    static bool ReadString(std::string_view Data, std::size_t& Offset, std::string_view& String)
+    {
+        u64 Length = 0;
+        if (!ReadVarint(Data, Offset, Length) || Length > Data.size() - Offset)
+            return false;
+
+        String = Data.substr(Offset, static_cast<std::size_t>(Length));
+        Offset += static_cast<std::size_t>(Length);
+        return true;
+    }
+
+    bool DecodeArguments(std::string_view Payload, std::vector<DecodedArgument>& Arguments)
+    {
+        Arguments.clear();
+
+        std::size_t Offset = 0;
+        while (Offset < Payload.size())
+        {
+            DecodedArgument& Argument = Arguments.emplace_back();
+            Argument.Type = static_cast<ArgumentType>(Payload[Offset++]);
+
+            bool Success = false;
+            switch (Argument.Type)
+            {
+                case(ArgumentType::Int):
+                {
+                    u64 ZigZag = 0;
+                    Success = ReadVarint(Payload, Offset, ZigZag);
+                    Argument.Int = static_cast<i64>(ZigZag >> 1) ^ -static_cast<i64>(ZigZag & 1);
+                    break;
+                }
+                case(ArgumentType::UInt):
+                case(ArgumentType::Pointer):
+                    Success = ReadVarint(Payload, Offset, Argument.UInt);
+                    break;
+                case(ArgumentType::F32):
+                {
+                    f32 Value = 0.0f;
+                    Success = ReadBytes(Payload, Offset, &Value, sizeof(Value));
+                    Argument.Float = Value;
+                    break;
+                }
+                case(ArgumentType::F64):
+                    Success = ReadBytes(Payload, Offset, &Argument.Float, sizeof(f64));
+                    break;
+                case(ArgumentType::Bool):
+                case(ArgumentType::Char):
+                {
+                    u8 Value = 0;
+                    Success = ReadBytes(Payload, Offset, &Value, sizeof(Value));
+                    Argument.UInt = Value;
+                    break;
+                }
+                case(ArgumentType::String):
+                    Success = ReadString(Payload, Offset, Argument.String);
+                    break;
+            }
+
+            if (!Success)
+                return false;
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    static void AppendNumber(std::string& Output, T Value)
+    {
+        char Buffer[32];
+        std::to_chars_result Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+        Output.append(Buffer, Result.ptr);
+    }
+
+    static void FormatArgument(std::string& Output, const DecodedArgument& Argument)
+    {
+        switch (Argument.Type)
+        {
+            case(ArgumentType::Int): AppendNumber(Output, Argument.Int); break;
+            case(ArgumentType::UInt): AppendNumber(Output, Argument.UInt); break;
+
+            //shortest text that reads back as the same f32, not the f64 it was widened to
+            case(ArgumentType::F32): AppendNumber(Output, static_cast<f32>(Argument.Float)); break;
+            case(ArgumentType::F64): AppendNumber(Output, Argument.Float); break;
+            case(ArgumentType::Bool): Output += Argument.UInt ? "true" : "false"; break;
+            case(ArgumentType::Char): Output += static_cast<char>(Argument.UInt); break;
+            case(ArgumentType::String): Output += Argument.String; break;
+            case(ArgumentType::Pointer):
+            {
+                char Buffer[24];
+                int Length = std::snprintf(Buffer, sizeof(Buffer), "0x%llx", static_cast<unsigned long long>(Argument.UInt));
+                Output.append(Buffer, static_cast<std::size_t>(std::max(Length, 0)));
+                break;
+            }
+        }
+    }
+
+    void FormatMessage(std::string& Output, std::string_view Format, const std::vector<DecodedArgument>& Arguments)
+    {
+        std::size_t ArgumentIndex = 0;
+
+        for (std::size_t i = 0; i < Format.size(); i++)
+        {
+            char Character = Format[i];
+            bool HasNext = i + 1 < Format.size();
+
+            if (Character == '{' && HasNext && Format[i + 1] == '}')
+            {
+                //the count is checked at compile time, a mismatch here means the payload was damaged
+                if (ArgumentIndex < Arguments.size())
+                    FormatArgument(Output, Arguments[ArgumentIndex++]);
+                else
+                    Output += "{}";
+
+                i++;
+            }
+            else if ((Character == '{' || Character == '}') && HasNext && Format[i + 1] == Character)
+            {
+                Output += Character;
+                i++;
+            }
+            else
+            {
+                Output += Character;
+            }
+        }
+    }
+
+    void AppendLine(std::string& Output, u64 Timestamp, LogLevel Level, LogCategory Category, std::string_view Message)
+    {
+        char Prefix[64];
+        int PrefixLength = std::snprintf(Prefix, sizeof(Prefix), "[%10.4f] [%s] [%s] ", static_cast<double>(Timestamp) / 1e9, GetLevelName(Level), GetCategoryName(Category));
+
+        //info logs from the driver usually end in a newline already
+        while (!Message.empty() && Message.back() == '\n')
+            Message.remove_suffix(1);
+
+        Output.append(Prefix, static_cast<std::size_t>(std::max(PrefixLength, 0)));
+        Output += Message;
+        Output += '\n';
+    }
+
+    static void WriteU32(std::string& Output, u32 Value)
+    {
+        Output.append(reinterpret_cast<const char*>(&Value), sizeof(Value));
+    }
+
+    void BinaryLogWriter::WriteHeader(std::string& Output)
+    {
+        FormatIndices.clear();
+        LastTimestamp = 0;
+
+        WriteU32(Output, BinaryLogMagic);
+        WriteU32(Output, BinaryLogVersion);
+    }
+
+    void BinaryLogWriter::WriteMessage(std::string& Output, u64 Timestamp, LogLevel Level, LogCategory Category, std::string_view Format, std::string_view Payload)
+    {
+        auto [Iterator, Inserted] = FormatIndices.try_emplace(Format.data(), static_cast<u32>(FormatIndices.size()));
+
+        if (Inserted)
+        {
+            Output += static_cast<char>(BinaryRecord::Format);
+            WriteVarint(Output, Iterator->second);
+            WriteVarint(Output, Format.size());
+            Output += Format;
+        }
+
+        //records are only sorted within one drain so a late message can step back in time
+        i64 Delta = static_cast<i64>(Timestamp - LastTimestamp);
+        LastTimestamp = Timestamp;
+
+        Output += static_cast<char>(BinaryRecord::Message);
+        WriteVarint(Output, Iterator->second);
+        Output += static_cast<char>(Level);
+        Output += static_cast<char>(Category);
+        WriteVarint(Output, (static_cast<u64>(Delta) << 1) ^ static_cast<u64>(Delta >> 63));
+        WriteVarint(Output, Payload.size());
+        Output += Payload;
+    }
+
+    bool DecodeBinaryLog(std::string_view Data, std::string& Output)
+    {
+        std::size_t Offset = 0;
+
+        u32 Magic = 0;
+        u32 Version = 0;
+        if (!ReadBytes(Data, Offset, &Magic, sizeof(Magic)) || !ReadBytes(Data, Offset, &Version, sizeof(Version)))
+            return false;
+
+        if (Magic != BinaryLogMagic || Version != BinaryLogVersion)
+            return false;
+
+        std::vector<std::string_view> Formats;
+        std::vector<DecodedArgument> Arguments;
+        std::string Message;
+        u64 Timestamp = 0;
+
+        while (Offset < Data.size())
+        {
+            BinaryRecord Type = static_cast<BinaryRecord>(Data[Offset++]);
+
+            if (Type == BinaryRecord::Format)
+            {
+                u64 Index = 0;
+                std::string_view Format;
+                if (!ReadVarint(Data, Offset, Index) || !ReadString(Data, Offset, Format) || Index != Formats.size())
+                    return false;
+
+                Formats.push_back(Format);
+            }
+            else if (Type == BinaryRecord::Message)
+            {
+                u64 Index = 0;
+                u8 Level = 0;
+                u8 Category = 0;
+                u64 ZigZag = 0;
+                std::string_view Payload;
+
+                if (!ReadVarint(Data, Offset, Index) || !ReadBytes(Data, Offset, &Level, 1) || !ReadBytes(Data, Offset, &Category, 1)
+                    || !ReadVarint(Data, Offset, ZigZag) || !ReadString(Data, Offset, Payload))
+                    return false;
+
+                if (Index >= Formats.size() || Level > static_cast<u8>(LogLevel::Error) || Category >= static_cast<u8>(LogCategory::Count))
+                    return false;
+
+                Timestamp += static_cast<u64>(static_cast<i64>(ZigZag >> 1) ^ -static_cast<i64>(ZigZag & 1));
+
+                if (!DecodeArguments(Payload, Arguments))
+                    return false;
+
+                Message.clear();
+                FormatMessage(Message, Formats[Index], Arguments);
+                AppendLine(Output, Timestamp, static_cast<LogLevel>(Level), static_cast<LogCategory>(Category), Message);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
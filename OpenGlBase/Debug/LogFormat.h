@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+#include "Log.h"
+
+namespace Base
+{
+    namespace Log
+    {
+        //one argument read back out of a payload, String points into the payload
+        struct DecodedArgument
+        {
+            ArgumentType Type = ArgumentType::Int;
+            i64 Int = 0;
+            u64 UInt = 0;
+            f64 Float = 0.0;
+            std::string_view String;
+        };
+
+        bool ReadVarint(std::string_view Data, std::size_t& Offset, u64& Value);
+
+        //false if the payload is cut short or has a tag this version doesn't know
+        bool DecodeArguments(std::string_view Payload, std::vector<DecodedArgument>& Arguments);
+
+        //replaces every {} with the next argument, {{ and }} are literal braces
+        void FormatMessage(std::string& Output, std::string_view Format, const std::vector<DecodedArgument>& Arguments);
+
+        //one line of the text log, "[   12.3456] [Warning] [Shader] message", Timestamp is in nanoseconds
+        void AppendLine(std::string& Output, u64 Timestamp, LogLevel Level, LogCategory Category, std::string_view Message);
+
+        //a binary log is a header followed by records, each starting with its BinaryRecord type.
+        //a format string is written once, the first time it is used, and messages refer to it by index.
+        //timestamps are the difference to the previous message so most of them fit in a byte or two
+        //
+        //  Format   varint index, varint length, text
+        //  Message  varint format index, u8 level, u8 category, varint zigzag timestamp delta, varint payload length, payload
+        constexpr u32 BinaryLogMagic = 0x4C424C47; //"GLBL"
+        constexpr u32 BinaryLogVersion = 1;
+
+        enum class BinaryRecord : u8
+        {
+            Format = 1,
+            Message = 2
+        };
+
+        //writer side, keeps the format strings it has written keyed by their address
+        class BinaryLogWriter
+        {
+        public:
+            void WriteHeader(std::string& Output);
+            void WriteMessage(std::string& Output, u64 Timestamp, LogLevel Level, LogCategory Category, std::string_view Format, std::string_view Payload);
+
+        private:
+            std::unordered_map<const char*, u32> FormatIndices;
+            u64 LastTimestamp = 0;
+        };
+
+        //turns a binary log back into the text the log would have written. a record cut short by a crash
+        //ends the decode but everything before it is still in Output
+        bool DecodeBinaryLog(std::string_view Data, std::string& Output);
+    }
+}
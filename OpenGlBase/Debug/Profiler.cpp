@@ -0,0 +1,598 @@
+#include "Profiler.h"
+#include "Log.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <string_view>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
+namespace Base::Profiler
+{
+    enum class EventType : u8
+    {
+        Begin,
+        End
+    };
+
+    struct Event
+    {
+        u64 Timestamp;
+        const char* Name;
+        EventType Type;
+    };
+
+    //single producer single consumer like the log rings, the owning thread moves Head and whoever
+    //collects under CaptureMutex moves Tail
+    struct Ring
+    {
+        std::unique_ptr<Event[]> Events = std::make_unique<Event[]>(EventsPerThread);
+
+        alignas(64) std::atomic<u64> Head = 0;
+        alignas(64) std::atomic<u64> Tail = 0;
+
+        std::atomic<bool> Retired = false;
+        u32 ThreadId = 0;
+
+        //guarded by RingMutex
+        std::string Name;
+    };
+
+    struct Zone
+    {
+        u64 Begin;
+        u64 End;
+        const char* Name;
+    };
+
+    //one row in the exported trace, a thread, the frame markers or a track added with AddTrack.
+    //added tracks only have Zones, which are turned into events when the trace is saved
+    struct Track
+    {
+        u32 Id = 0;
+        std::string Name;
+        bool Thread = false;
+        std::vector<Event> Events;
+        std::vector<Zone> Zones;
+    };
+
+    struct ProfilerState
+    {
+        std::atomic<bool> Capturing = false;
+
+        std::mutex RingMutex;
+        std::vector<std::shared_ptr<Ring>> Rings;
+        std::vector<std::pair<u32, std::string>> AddedTracks;
+
+        //shared by threads and added tracks so their ids never collide
+        u32 NextTrackId = 1;
+
+        std::mutex CaptureMutex;
+        std::vector<Track> Tracks;
+        std::unordered_map<u32, std::size_t> TrackIndices;
+        std::vector<std::shared_ptr<Ring>> CollectRings;
+        u64 CaptureStart = 0;
+        u64 CaptureEnd = 0;
+        u64 LastFrame = 0;
+        u32 FrameLimit = 0;
+        u32 FrameCount = 0;
+    };
+
+    static ProfilerState State;
+    static const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+    static constexpr u32 FrameTrackId = 0;
+    static constexpr u32 ProcessId = 1;
+
+    struct ThreadState
+    {
+        std::shared_ptr<Ring> Instance;
+
+        //recorded zones that haven't ended yet, each one has a slot kept free for its end
+        u32 OpenZones = 0;
+
+        ~ThreadState()
+        {
+            if (Instance)
+                Instance->Retired.store(true, std::memory_order_release);
+        }
+    };
+
+    static thread_local ThreadState Thread;
+
+    static Ring& GetRing()
+    {
+        if (!Thread.Instance)
+        {
+            Thread.Instance = std::make_shared<Ring>();
+
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            Thread.Instance->ThreadId = State.NextTrackId++;
+            Thread.Instance->Name = "Thread " + std::to_string(Thread.Instance->ThreadId);
+            State.Rings.push_back(Thread.Instance);
+        }
+
+        return *Thread.Instance;
+    }
+
+    u64 GetTimestamp()
+    {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime).count());
+    }
+
+    bool BeginZone(const char* Name)
+    {
+        if (!State.Capturing.load(std::memory_order_relaxed))
+            return false;
+
+        Ring& Target = GetRing();
+
+        u64 Head = Target.Head.load(std::memory_order_relaxed);
+        u64 Tail = Target.Tail.load(std::memory_order_acquire);
+
+        //room for this zone's begin and end plus the ends of every zone that is already open
+        if (EventsPerThread - (Head - Tail) < Thread.OpenZones + 2)
+            return false;
+
+        Target.Events[Head % EventsPerThread] = { GetTimestamp(), Name, EventType::Begin };
+        Target.Head.store(Head + 1, std::memory_order_release);
+
+        Thread.OpenZones++;
+        return true;
+    }
+
+    void EndZone()
+    {
+        Ring& Target = *Thread.Instance;
+
+        u64 Head = Target.Head.load(std::memory_order_relaxed);
+        Target.Events[Head % EventsPerThread] = { GetTimestamp(), nullptr, EventType::End };
+        Target.Head.store(Head + 1, std::memory_order_release);
+
+        Thread.OpenZones--;
+    }
+
+    static Track& GetTrack(u32 Id)
+    {
+        auto [Iterator, Inserted] = State.TrackIndices.try_emplace(Id, State.Tracks.size());
+        if (Inserted)
+            State.Tracks.emplace_back().Id = Id;
+
+        return State.Tracks[Iterator->second];
+    }
+
+    //needs CaptureMutex, moves everything the rings hold into the capture or throws it away
+    static void Collect(bool Keep)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            State.CollectRings = State.Rings;
+
+            if (Keep)
+            {
+                for (const std::shared_ptr<Ring>& Source : State.CollectRings)
+                {
+                    Track& Target = GetTrack(Source->ThreadId);
+                    Target.Name = Source->Name;
+                    Target.Thread = true;
+                }
+            }
+        }
+
+        bool HasRetired = false;
+        for (const std::shared_ptr<Ring>& Source : State.CollectRings)
+        {
+            bool Retired = Source->Retired.load(std::memory_order_acquire);
+
+            u64 Tail = Source->Tail.load(std::memory_order_relaxed);
+            u64 Head = Source->Head.load(std::memory_order_acquire);
+
+            if (Keep)
+            {
+                std::vector<Event>& Events = GetTrack(Source->ThreadId).Events;
+                for (; Tail != Head; Tail++)
+                    Events.push_back(Source->Events[Tail % EventsPerThread]);
+            }
+
+            Source->Tail.store(Head, std::memory_order_release);
+            HasRetired |= Retired;
+        }
+
+        State.CollectRings.clear();
+
+        if (HasRetired)
+        {
+            std::lock_guard<std::mutex> Lock(State.RingMutex);
+            std::erase_if(State.Rings, [](const std::shared_ptr<Ring>& Source)
+            {
+                return Source->Retired.load(std::memory_order_acquire) && Source->Head.load(std::memory_order_acquire) == Source->Tail.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    void BeginCapture(u32 FrameCount)
+    {
+        std::lock_guard<std::mutex> Lock(State.CaptureMutex);
+
+        Collect(false);
+
+        State.Tracks.clear();
+        State.TrackIndices.clear();
+        GetTrack(FrameTrackId).Name = "Frames";
+
+        {
+            std::lock_guard<std::mutex> RingLock(State.RingMutex);
+            for (const auto& [Id, Name] : State.AddedTracks)
+                GetTrack(Id).Name = Name;
+        }
+
+        State.CaptureStart = GetTimestamp();
+        State.CaptureEnd = State.CaptureStart;
+        State.LastFrame = 0;
+        State.FrameLimit = FrameCount;
+        State.FrameCount = 0;
+
+        State.Capturing.store(true, std::memory_order_relaxed);
+    }
+
+    static void EndCaptureLocked(u64 Timestamp)
+    {
+        State.Capturing.store(false, std::memory_order_relaxed);
+
+        Collect(true);
+        State.CaptureEnd = Timestamp;
+    }
+
+    void EndCapture()
+    {
+        std::lock_guard<std::mutex> Lock(State.CaptureMutex);
+
+        if (State.Capturing.load(std::memory_order_relaxed))
+            EndCaptureLocked(GetTimestamp());
+    }
+
+    bool IsCapturing()
+    {
+        return State.Capturing.load(std::memory_order_relaxed);
+    }
+
+    void MarkFrame()
+    {
+        u64 Now = GetTimestamp();
+
+        std::lock_guard<std::mutex> Lock(State.CaptureMutex);
+
+        if (!State.Capturing.load(std::memory_order_relaxed))
+        {
+            //keeps the rings empty for the next capture
+            Collect(false);
+            return;
+        }
+
+        Collect(true);
+
+        //the time before the first boundary is only part of a frame
+        if (State.LastFrame != 0)
+        {
+            std::vector<Event>& Frames = GetTrack(FrameTrackId).Events;
+            Frames.push_back({ State.LastFrame, "Frame", EventType::Begin });
+            Frames.push_back({ Now, nullptr, EventType::End });
+            State.FrameCount++;
+        }
+
+        State.LastFrame = Now;
+
+        if (State.FrameLimit != 0 && State.FrameCount >= State.FrameLimit)
+            EndCaptureLocked(Now);
+    }
+
+    u32 AddTrack(const char* Name)
+    {
+        std::lock_guard<std::mutex> Lock(State.RingMutex);
+
+        u32 Id = State.NextTrackId++;
+        State.AddedTracks.emplace_back(Id, Name);
+        return Id;
+    }
+
+    void AddZone(u32 TrackId, const char* Name, u64 Begin, u64 End)
+    {
+        std::lock_guard<std::mutex> Lock(State.CaptureMutex);
+
+        bool InCapture = Begin >= State.CaptureStart && (State.Capturing.load(std::memory_order_relaxed) || Begin <= State.CaptureEnd);
+
+        if (!InCapture || State.Tracks.empty())
+            return;
+
+        //the track may have been added after the capture began
+        Track& Target = GetTrack(TrackId);
+        if (Target.Name.empty())
+        {
+            std::lock_guard<std::mutex> RingLock(State.RingMutex);
+            for (const auto& [Id, TrackName] : State.AddedTracks)
+            {
+                if (Id == TrackId)
+                    Target.Name = TrackName;
+            }
+        }
+
+        Target.Zones.push_back({ Begin, std::max(Begin, End), Name });
+    }
+
+    void SetThreadName(const char* Name)
+    {
+        Ring& Target = GetRing();
+
+        std::lock_guard<std::mutex> Lock(State.RingMutex);
+        Target.Name = Name;
+    }
+
+    //turns complete zones into begin and end events, zones that overlap without nesting are cut
+    //short at the end of the zone they started in
+    static void ConvertZones(std::vector<Zone> Zones, std::vector<Event>& Events)
+    {
+        std::sort(Zones.begin(), Zones.end(), [](const Zone& A, const Zone& B)
+        {
+            return A.Begin != B.Begin ? A.Begin < B.Begin : A.End > B.End;
+        });
+
+        std::vector<u64> OpenEnds;
+
+        for (Zone& Current : Zones)
+        {
+            while (!OpenEnds.empty() && OpenEnds.back() <= Current.Begin)
+            {
+                Events.push_back({ OpenEnds.back(), nullptr, EventType::End });
+                OpenEnds.pop_back();
+            }
+
+            if (!OpenEnds.empty())
+                Current.End = std::min(Current.End, OpenEnds.back());
+
+            Events.push_back({ Current.Begin, Current.Name, EventType::Begin });
+            OpenEnds.push_back(Current.End);
+        }
+
+        for (auto Iterator = OpenEnds.rbegin(); Iterator != OpenEnds.rend(); ++Iterator)
+            Events.push_back({ *Iterator, nullptr, EventType::End });
+    }
+
+    //calls Visit(Event) for every event of a track with begins and ends balanced, ends without a begin
+    //are from zones that were open when the capture started and zones still open get closed at End
+    template<typename Visitor>
+    static void VisitBalanced(const Track& Source, u64 End, Visitor&& Visit)
+    {
+        u32 Depth = 0;
+
+        const std::vector<Event>* Events = &Source.Events;
+
+        std::vector<Event> Converted;
+        if (!Source.Zones.empty())
+        {
+            ConvertZones(Source.Zones, Converted);
+            Events = &Converted;
+        }
+
+        for (const Event& Current : *Events)
+        {
+            if (Current.Type == EventType::End)
+            {
+                if (Depth == 0)
+                    continue;
+
+                Depth--;
+            }
+            else
+            {
+                Depth++;
+            }
+
+            Visit(Current);
+        }
+
+        for (; Depth > 0; Depth--)
+            Visit(Event{ End, nullptr, EventType::End });
+    }
+
+    static void AppendJsonString(std::string& Output, std::string_view String)
+    {
+        Output += '"';
+        for (char Character : String)
+        {
+            if (Character == '"' || Character == '\\')
+                Output += '\\';
+
+            if (static_cast<u8>(Character) < 0x20)
+                Output += ' ';
+            else
+                Output += Character;
+        }
+        Output += '"';
+    }
+
+    static bool WriteFile(const std::string& Path, const std::string& Data)
+    {
+        std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+        if (!File || !File.write(Data.data(), Data.size()))
+        {
+            Log::Error<LogCategory::Profiler>("Failed to write trace {}", Path);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SaveChromeTrace(const std::string& Path)
+    {
+        std::lock_guard<std::mutex> Lock(State.CaptureMutex);
+
+        std::string Output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool First = true;
+
+        auto BeginEntry = [&]()
+        {
+            if (!First)
+                Output += ",\n";
+            First = false;
+        };
+
+        char Buffer[128];
+
+        for (const Track& Source : State.Tracks)
+        {
+            BeginEntry();
+            std::snprintf(Buffer, sizeof(Buffer), "{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", ProcessId, Source.Id);
+            Output += Buffer;
+            AppendJsonString(Output, Source.Name);
+            Output += "}}";
+
+            //keeps the tracks in the order they were first seen, frames at the top
+            BeginEntry();
+            std::snprintf(Buffer, sizeof(Buffer), "{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%u}}", ProcessId, Source.Id, Source.Id);
+            Output += Buffer;
+
+            VisitBalanced(Source, State.CaptureEnd, [&](const Event& Current)
+            {
+                //chrome wants microseconds, the fraction keeps the nanoseconds
+                f64 Microseconds = static_cast<f64>(Current.Timestamp - State.CaptureStart) / 1000.0;
+
+                BeginEntry();
+                std::snprintf(Buffer, sizeof(Buffer), "{\"ph\":\"%c\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f", Current.Type == EventType::Begin ? 'B' : 'E', ProcessId, Source.Id, Microseconds);
+                Output += Buffer;
+
+                if (Current.Type == EventType::Begin)
+                {
+                    Output += ",\"name\":";
+                    AppendJsonString(Output, Current.Name);
+                }
+
+                Output += '}';
+            });
+        }
+
+        Output += "\n]}\n";
+        return WriteFile(Path, Output);
+    }
+
+    //just enough of the protobuf wire format for perfetto's TracePacket, field numbers are from
+    //perfetto's trace_packet.proto, track_event.proto and track_descriptor.proto
+    static void WriteVarint(std::string& Output, u64 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Output += static_cast<char>(Value | 0x80);
+            Value >>= 7;
+        }
+        Output += static_cast<char>(Value);
+    }
+
+    static void WriteUInt(std::string& Output, u32 Field, u64 Value)
+    {
+        WriteVarint(Output, Field << 3);
+        WriteVarint(Output, Value);
+    }
+
+    static void WriteBytes(std::string& Output, u32 Field, std::string_view Bytes)
+    {
+        WriteVarint(Output, (Field << 3) | 2);
+        WriteVarint(Output, Bytes.size());
+        Output += Bytes;
+    }
+
+    namespace Perfetto
+    {
+        constexpr u32 TracePacket = 1;
+
+        constexpr u32 PacketTimestamp = 8;
+        constexpr u32 PacketSequenceId = 10;
+        constexpr u32 PacketTrackEvent = 11;
+        constexpr u32 PacketSequenceFlags = 13;
+        constexpr u32 PacketTrackDescriptor = 60;
+
+        constexpr u32 DescriptorUuid = 1;
+        constexpr u32 DescriptorName = 2;
+        constexpr u32 DescriptorThread = 4;
+
+        constexpr u32 ThreadPid = 1;
+        constexpr u32 ThreadTid = 2;
+        constexpr u32 ThreadName = 5;
+
+        constexpr u32 EventType = 9;
+        constexpr u32 EventTrackUuid = 11;
+        constexpr u32 EventName = 23;
+
+        constexpr u32 SliceBegin = 1;
+        constexpr u32 SliceEnd = 2;
+
+        constexpr u32 IncrementalStateCleared = 1;
+        constexpr u32 SequenceId = 1;
+    }
+
+    bool SavePerfettoTrace(const std::string& Path)
+    {
+        std::lock_guard<std::mutex> Lock(State.CaptureMutex);
+
+        std::string Output;
+        std::string Packet;
+        std::string Message;
+        std::string Nested;
+        bool First = true;
+
+        auto FlushPacket = [&]()
+        {
+            WriteUInt(Packet, Perfetto::PacketSequenceId, Perfetto::SequenceId);
+
+            if (First)
+                WriteUInt(Packet, Perfetto::PacketSequenceFlags, Perfetto::IncrementalStateCleared);
+            First = false;
+
+            WriteBytes(Output, Perfetto::TracePacket, Packet);
+            Packet.clear();
+        };
+
+        for (const Track& Source : State.Tracks)
+        {
+            //uuid 0 means no track, every uuid is offset by one
+            u64 Uuid = Source.Id + 1;
+
+            Message.clear();
+            WriteUInt(Message, Perfetto::DescriptorUuid, Uuid);
+
+            if (!Source.Thread)
+            {
+                WriteBytes(Message, Perfetto::DescriptorName, Source.Name);
+            }
+            else
+            {
+                Nested.clear();
+                WriteUInt(Nested, Perfetto::ThreadPid, ProcessId);
+                WriteUInt(Nested, Perfetto::ThreadTid, Source.Id);
+                WriteBytes(Nested, Perfetto::ThreadName, Source.Name);
+                WriteBytes(Message, Perfetto::DescriptorThread, Nested);
+            }
+
+            WriteBytes(Packet, Perfetto::PacketTrackDescriptor, Message);
+            FlushPacket();
+
+            VisitBalanced(Source, State.CaptureEnd, [&](const Event& Current)
+            {
+                Message.clear();
+                WriteUInt(Message, Perfetto::EventType, Current.Type == EventType::Begin ? Perfetto::SliceBegin : Perfetto::SliceEnd);
+                WriteUInt(Message, Perfetto::EventTrackUuid, Uuid);
+
+                if (Current.Type == EventType::Begin)
+                    WriteBytes(Message, Perfetto::EventName, Current.Name);
+
+                WriteUInt(Packet, Perfetto::PacketTimestamp, Current.Timestamp);
+                WriteBytes(Packet, Perfetto::PacketTrackEvent, Message);
+                FlushPacket();
+            });
+        }
+
+        return WriteFile(Path, Output);
+    }
+}
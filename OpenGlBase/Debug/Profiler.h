@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+
+//with PROFILER_ENABLED set to 0 every PROFILE_ macro compiles to nothing, the Profiler functions stay
+//available so capture and export code doesn't need its own #if
+#ifndef PROFILER_ENABLED
+    #define PROFILER_ENABLED 1
+#endif
+
+#if PROFILER_ENABLED
+    #define PROFILE_CONCAT_INNER(A, B) A##B
+    #define PROFILE_CONCAT(A, B) PROFILE_CONCAT_INNER(A, B)
+
+    //names have to be string literals, only the pointer is recorded
+    #define PROFILE_SCOPE(Name) ::Base::ProfileZone PROFILE_CONCAT(ProfileZone, __LINE__)(Name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+    #define PROFILE_FRAME() ::Base::Profiler::MarkFrame()
+    #define PROFILE_THREAD_NAME(Name) ::Base::Profiler::SetThreadName(Name)
+#else
+    #define PROFILE_SCOPE(Name) ((void)0)
+    #define PROFILE_FUNCTION() ((void)0)
+    #define PROFILE_FRAME() ((void)0)
+    #define PROFILE_THREAD_NAME(Name) ((void)0)
+#endif
+
+namespace Base
+{
+    //zones are recorded into a ring per thread without locks and moved into the capture at every frame
+    //boundary, so a ring only has to hold one frame's worth of events. when it is full new zones are
+    //dropped, never their ends
+    namespace Profiler
+    {
+        constexpr u32 EventsPerThread = 1 << 16;
+
+        //FrameCount stops the capture on its own after that many frames, 0 records until EndCapture
+        void BeginCapture(u32 FrameCount = 0);
+        void EndCapture();
+        bool IsCapturing();
+
+        //frame boundary, Window::Tick calls it after swapping buffers
+        void MarkFrame();
+
+        //shown as the thread's track name, copied
+        void SetThreadName(const char* Name);
+
+        //nanoseconds since startup on the clock every zone is recorded with
+        u64 GetTimestamp();
+
+        //the last capture, zones still open when it ended are closed at its end
+        bool SaveChromeTrace(const std::string& Path);
+        bool SavePerfettoTrace(const std::string& Path);
+
+        //a timeline the CPU doesn't record itself, like GPU timer queries. its zones are added complete,
+        //can arrive a few frames late and are kept if they began inside the last capture
+        u32 AddTrack(const char* Name);
+        void AddZone(u32 Track, const char* Name, u64 Begin, u64 End);
+
+        //what ProfileZone uses, EndZone only for a BeginZone that returned true
+        bool BeginZone(const char* Name);
+        void EndZone();
+    }
+
+    class ProfileZone
+    {
+    public:
+        explicit ProfileZone(const char* Name)
+            : Recorded(Profiler::BeginZone(Name))
+        {
+        }
+
+        ~ProfileZone()
+        {
+            if (Recorded)
+                Profiler::EndZone();
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        bool Recorded;
+    };
+}
@@ -0,0 +1,204 @@
+#include "FileWatcher.h"
+#include "../Debug/Log.h"
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace Base
+{
+    FileWatcher::FileWatcher(const FileWatcherConfig& WatcherConfig)
+        : Config(WatcherConfig)
+    {
+#ifdef __linux__
+        Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (Inotify == -1)
+        {
+            Log::Error<LogCategory::FileSystem>("Failed to initialise inotify: {}", std::strerror(errno));
+            return;
+        }
+#endif
+
+        Thread = std::thread(&FileWatcher::Run, this);
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        Running = false;
+
+        if (Thread.joinable())
+            Thread.join();
+
+#ifdef __linux__
+        if (Inotify != -1)
+            close(Inotify);
+#endif
+    }
+
+#ifdef __linux__
+    bool FileWatcher::Watch(const std::string& Path)
+    {
+        if (Inotify == -1)
+            return false;
+
+        std::filesystem::path FilePath(Path);
+        std::string Directory = FilePath.has_parent_path() ? FilePath.parent_path().string() : ".";
+
+        //adding a directory that is already watched hands back its existing descriptor
+        int Descriptor = inotify_add_watch(Inotify, Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (Descriptor == -1)
+        {
+            Log::Warning<LogCategory::FileSystem>("Failed to watch {}: {}", Directory, std::strerror(errno));
+            return false;
+        }
+
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        WatchedDirectory& Watched = Directories[Descriptor];
+        Watched.Path = Directory;
+        Watched.Files[FilePath.filename().string()] = Path;
+
+        return true;
+    }
+
+    void FileWatcher::Unwatch(const std::string& Path)
+    {
+        std::filesystem::path FilePath(Path);
+        std::string Name = FilePath.filename().string();
+
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        for (auto Iterator = Directories.begin(); Iterator != Directories.end(); ++Iterator)
+        {
+            auto File = Iterator->second.Files.find(Name);
+            if (File == Iterator->second.Files.end() || File->second != Path)
+                continue;
+
+            Iterator->second.Files.erase(File);
+
+            if (Iterator->second.Files.empty())
+            {
+                inotify_rm_watch(Inotify, Iterator->first);
+                Directories.erase(Iterator);
+            }
+
+            return;
+        }
+    }
+
+    void FileWatcher::Run()
+    {
+        while (Running)
+        {
+            //wake up regularly so the destructor never waits long on the join
+            pollfd Descriptor = { Inotify, POLLIN, 0 };
+            if (poll(&Descriptor, 1, 100) > 0)
+                ReadEvents();
+        }
+    }
+
+    void FileWatcher::ReadEvents()
+    {
+        alignas(inotify_event) char Buffer[4096];
+
+        while (true)
+        {
+            ssize_t Length = read(Inotify, Buffer, sizeof(Buffer));
+            if (Length <= 0)
+                return;
+
+            std::lock_guard<std::mutex> Lock(Mutex);
+
+            for (char* Event = Buffer; Event < Buffer + Length;)
+            {
+                const inotify_event* Info = reinterpret_cast<const inotify_event*>(Event);
+                Event += sizeof(inotify_event) + Info->len;
+
+                if (Info->len == 0)
+                    continue;
+
+                auto Directory = Directories.find(Info->wd);
+                if (Directory == Directories.end())
+                    continue;
+
+                auto File = Directory->second.Files.find(Info->name);
+                if (File != Directory->second.Files.end())
+                    Changed.insert(File->second);
+            }
+        }
+    }
+#else
+    bool FileWatcher::Watch(const std::string& Path)
+    {
+        std::error_code Error;
+        std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(Path, Error);
+
+        if (Error)
+        {
+            Log::Warning<LogCategory::FileSystem>("Failed to watch {}: {}", Path, Error.message());
+            return false;
+        }
+
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Files[Path] = WriteTime;
+
+        return true;
+    }
+
+    void FileWatcher::Unwatch(const std::string& Path)
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Files.erase(Path);
+    }
+
+    void FileWatcher::Run()
+    {
+        //sleep in short steps so the destructor never waits a whole interval on the join
+        auto NextPoll = std::chrono::steady_clock::now();
+
+        while (Running)
+        {
+            if (std::chrono::steady_clock::now() >= NextPoll)
+            {
+                PollFiles();
+                NextPoll = std::chrono::steady_clock::now() + std::chrono::milliseconds(Config.PollIntervalMs);
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void FileWatcher::PollFiles()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        for (auto& [Path, LastWriteTime] : Files)
+        {
+            //a file that is missing for a moment is usually just being saved, check again next time
+            std::error_code Error;
+            std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(Path, Error);
+
+            if (!Error && WriteTime != LastWriteTime)
+            {
+                LastWriteTime = WriteTime;
+                Changed.insert(Path);
+            }
+        }
+    }
+#endif
+
+    std::vector<std::string> FileWatcher::TakeChangedFiles()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        std::vector<std::string> Result(Changed.begin(), Changed.end());
+        Changed.clear();
+
+        return Result;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+namespace Base
+{
+    struct FileWatcherConfig
+    {
+        //only used where there is no inotify and files are polled for their write time instead
+        u32 PollIntervalMs = 250;
+    };
+
+    //watches individual files from a background thread and collects the ones that changed until
+    //TakeChangedFiles is called, paths are reported exactly as they were passed to Watch
+    //
+    //on linux this uses inotify on the containing directories, since most editors save by writing a
+    //new file and renaming it over the old one a watch on the file itself would be lost on the first save
+    class FileWatcher
+    {
+    public:
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        FileWatcher(const FileWatcherConfig& WatcherConfig = {});
+        ~FileWatcher();
+
+        bool Watch(const std::string& Path);
+        void Unwatch(const std::string& Path);
+
+        std::vector<std::string> TakeChangedFiles();
+
+    private:
+        FileWatcherConfig Config;
+
+        std::thread Thread;
+        std::atomic<bool> Running = true;
+
+        std::mutex Mutex;
+        std::unordered_set<std::string> Changed;
+
+#ifdef __linux__
+        int Inotify = -1;
+
+        struct WatchedDirectory
+        {
+            std::string Path;
+
+            //file name inside the directory to the path it was watched with
+            std::unordered_map<std::string, std::string> Files;
+        };
+
+        //keyed by inotify watch descriptor
+        std::unordered_map<int, WatchedDirectory> Directories;
+
+        void ReadEvents();
+#else
+        std::unordered_map<std::string, std::filesystem::file_time_type> Files;
+
+        void PollFiles();
+#endif
+
+        void Run();
+    };
+}
@@ -0,0 +1,50 @@
+#include "VirtualFileSystem.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+namespace Base
+{
+    DiskFileSystem::DiskFileSystem(const std::string& RootDirectory)
+        : Root(RootDirectory)
+    {
+    }
+
+    bool DiskFileSystem::ReadFile(const std::string& Path, std::string& Contents)
+    {
+        std::ifstream File(GetFullPath(Path), std::ios::binary);
+        if (!File)
+            return false;
+
+        std::ostringstream Stream;
+        Stream << File.rdbuf();
+        Contents = Stream.str();
+
+        return true;
+    }
+
+    std::string DiskFileSystem::GetFullPath(const std::string& Path) const
+    {
+        return (std::filesystem::path(Root) / Path).string();
+    }
+
+    void MemoryFileSystem::AddFile(const std::string& Path, std::string Contents)
+    {
+        Files[Path] = std::move(Contents);
+    }
+
+    void MemoryFileSystem::RemoveFile(const std::string& Path)
+    {
+        Files.erase(Path);
+    }
+
+    bool MemoryFileSystem::ReadFile(const std::string& Path, std::string& Contents)
+    {
+        auto Iterator = Files.find(Path);
+        if (Iterator == Files.end())
+            return false;
+
+        Contents = Iterator->second;
+        return true;
+    }
+}
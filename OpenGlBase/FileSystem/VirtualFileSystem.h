@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+
+namespace Base
+{
+    //paths are always relative to the root of the file system and use forward slashes
+    class VirtualFileSystem
+    {
+    public:
+        virtual ~VirtualFileSystem() = default;
+
+        virtual bool ReadFile(const std::string& Path, std::string& Contents) = 0;
+    };
+
+    class DiskFileSystem : public VirtualFileSystem
+    {
+    public:
+        DiskFileSystem(const std::string& RootDirectory);
+
+        bool ReadFile(const std::string& Path, std::string& Contents) override;
+
+        std::string GetFullPath(const std::string& Path) const;
+
+    private:
+        std::string Root;
+    };
+
+    class MemoryFileSystem : public VirtualFileSystem
+    {
+    public:
+        void AddFile(const std::string& Path, std::string Contents);
+        void RemoveFile(const std::string& Path);
+
+        bool ReadFile(const std::string& Path, std::string& Contents) override;
+
+    private:
+        std::unordered_map<std::string, std::string> Files;
+    };
+}
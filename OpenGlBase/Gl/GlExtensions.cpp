@@ -0,0 +1,217 @@
+#include "GlExtensions.h"
+#include <cstring>
+#include <string>
+
+PFNGLGETPROGRAMBINARYPROC glext_glGetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC glext_glProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC glext_glProgramParameteri = nullptr;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glext_glMaxShaderCompilerThreadsKHR = nullptr;
+PFNGLBUFFERSTORAGEPROC glext_glBufferStorage = nullptr;
+PFNGLMEMORYBARRIERPROC glext_glMemoryBarrier = nullptr;
+PFNGLDISPATCHCOMPUTEPROC glext_glDispatchCompute = nullptr;
+PFNGLDISPATCHCOMPUTEINDIRECTPROC glext_glDispatchComputeIndirect = nullptr;
+PFNGLSHADERSTORAGEBLOCKBINDINGPROC glext_glShaderStorageBlockBinding = nullptr;
+PFNGLGETPROGRAMINTERFACEIVPROC glext_glGetProgramInterfaceiv = nullptr;
+PFNGLGETPROGRAMRESOURCENAMEPROC glext_glGetProgramResourceName = nullptr;
+PFNGLGETPROGRAMRESOURCEIVPROC glext_glGetProgramResourceiv = nullptr;
+PFNGLGENPROGRAMPIPELINESPROC glext_glGenProgramPipelines = nullptr;
+PFNGLDELETEPROGRAMPIPELINESPROC glext_glDeleteProgramPipelines = nullptr;
+PFNGLBINDPROGRAMPIPELINEPROC glext_glBindProgramPipeline = nullptr;
+PFNGLUSEPROGRAMSTAGESPROC glext_glUseProgramStages = nullptr;
+PFNGLACTIVESHADERPROGRAMPROC glext_glActiveShaderProgram = nullptr;
+PFNGLVALIDATEPROGRAMPIPELINEPROC glext_glValidateProgramPipeline = nullptr;
+PFNGLGETPROGRAMPIPELINEIVPROC glext_glGetProgramPipelineiv = nullptr;
+PFNGLGETPROGRAMPIPELINEINFOLOGPROC glext_glGetProgramPipelineInfoLog = nullptr;
+PFNGLPROGRAMUNIFORM1IVPROC glext_glProgramUniform1iv = nullptr;
+PFNGLPROGRAMUNIFORM1UIVPROC glext_glProgramUniform1uiv = nullptr;
+PFNGLPROGRAMUNIFORM1FVPROC glext_glProgramUniform1fv = nullptr;
+PFNGLPROGRAMUNIFORM2IVPROC glext_glProgramUniform2iv = nullptr;
+PFNGLPROGRAMUNIFORM2UIVPROC glext_glProgramUniform2uiv = nullptr;
+PFNGLPROGRAMUNIFORM2FVPROC glext_glProgramUniform2fv = nullptr;
+PFNGLPROGRAMUNIFORM3IVPROC glext_glProgramUniform3iv = nullptr;
+PFNGLPROGRAMUNIFORM3UIVPROC glext_glProgramUniform3uiv = nullptr;
+PFNGLPROGRAMUNIFORM3FVPROC glext_glProgramUniform3fv = nullptr;
+PFNGLPROGRAMUNIFORM4IVPROC glext_glProgramUniform4iv = nullptr;
+PFNGLPROGRAMUNIFORM4UIVPROC glext_glProgramUniform4uiv = nullptr;
+PFNGLPROGRAMUNIFORM4FVPROC glext_glProgramUniform4fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX2FVPROC glext_glProgramUniformMatrix2fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX3FVPROC glext_glProgramUniformMatrix3fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX4FVPROC glext_glProgramUniformMatrix4fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX2X3FVPROC glext_glProgramUniformMatrix2x3fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX3X2FVPROC glext_glProgramUniformMatrix3x2fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX2X4FVPROC glext_glProgramUniformMatrix2x4fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX4X2FVPROC glext_glProgramUniformMatrix4x2fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX3X4FVPROC glext_glProgramUniformMatrix3x4fv = nullptr;
+PFNGLPROGRAMUNIFORMMATRIX4X3FVPROC glext_glProgramUniformMatrix4x3fv = nullptr;
+PFNGLSHADERBINARYPROC glext_glShaderBinary = nullptr;
+PFNGLSPECIALIZESHADERPROC glext_glSpecializeShader = nullptr;
+
+namespace Base
+{
+    static GlExtensionSupport Support;
+
+    static bool IsGlVersionAtLeast(int Major, int Minor)
+    {
+        return GLVersion.major > Major || (GLVersion.major == Major && GLVersion.minor >= Minor);
+    }
+
+    template<typename T>
+    static bool LoadProc(GLADloadproc Load, T& Proc, const char* Name)
+    {
+        Proc = reinterpret_cast<T>(Load(Name));
+        return Proc != nullptr;
+    }
+
+    //for extensions that only differ from core by a vendor suffix on every name
+    template<typename T>
+    static bool LoadProc(GLADloadproc Load, T& Proc, const char* Name, const char* Suffix)
+    {
+        return LoadProc(Load, Proc, (std::string(Name) + Suffix).c_str());
+    }
+
+    void LoadGlExtensions(GLADloadproc Load)
+    {
+        Support = GlExtensionSupport{};
+
+        if (IsGlVersionAtLeast(4, 1) || IsGlExtensionSupported("GL_ARB_get_program_binary"))
+        {
+            bool Loaded = true;
+            Loaded &= LoadProc(Load, glext_glGetProgramBinary, "glGetProgramBinary");
+            Loaded &= LoadProc(Load, glext_glProgramBinary, "glProgramBinary");
+            Loaded &= LoadProc(Load, glext_glProgramParameteri, "glProgramParameteri");
+
+            GLint FormatCount = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &FormatCount);
+
+            //some drivers expose the entry points but no formats, which makes the cache useless
+            Support.ProgramBinary = Loaded && FormatCount > 0;
+        }
+
+        if (IsGlExtensionSupported("GL_KHR_parallel_shader_compile"))
+        {
+            Support.ParallelShaderCompile = LoadProc(Load, glext_glMaxShaderCompilerThreadsKHR, "glMaxShaderCompilerThreadsKHR");
+        }
+        else if (IsGlExtensionSupported("GL_ARB_parallel_shader_compile"))
+        {
+            Support.ParallelShaderCompile = LoadProc(Load, glext_glMaxShaderCompilerThreadsKHR, "glMaxShaderCompilerThreadsARB");
+        }
+
+        if (IsGlVersionAtLeast(4, 4) || IsGlExtensionSupported("GL_ARB_buffer_storage"))
+        {
+            Support.BufferStorage = LoadProc(Load, glext_glBufferStorage, "glBufferStorage");
+        }
+
+        if (IsGlVersionAtLeast(4, 2) || IsGlExtensionSupported("GL_ARB_shader_image_load_store"))
+        {
+            Support.MemoryBarriers = LoadProc(Load, glext_glMemoryBarrier, "glMemoryBarrier");
+        }
+
+        //compute is useless without a barrier to see its results
+        if (Support.MemoryBarriers && (IsGlVersionAtLeast(4, 3) || IsGlExtensionSupported("GL_ARB_compute_shader")))
+        {
+            bool Loaded = true;
+            Loaded &= LoadProc(Load, glext_glDispatchCompute, "glDispatchCompute");
+            Loaded &= LoadProc(Load, glext_glDispatchComputeIndirect, "glDispatchComputeIndirect");
+
+            Support.ComputeShader = Loaded;
+        }
+
+        bool HasStorageBuffers = IsGlExtensionSupported("GL_ARB_shader_storage_buffer_object") && IsGlExtensionSupported("GL_ARB_program_interface_query");
+        if (IsGlVersionAtLeast(4, 3) || HasStorageBuffers)
+        {
+            bool Loaded = true;
+            Loaded &= LoadProc(Load, glext_glShaderStorageBlockBinding, "glShaderStorageBlockBinding");
+            Loaded &= LoadProc(Load, glext_glGetProgramInterfaceiv, "glGetProgramInterfaceiv");
+            Loaded &= LoadProc(Load, glext_glGetProgramResourceName, "glGetProgramResourceName");
+            Loaded &= LoadProc(Load, glext_glGetProgramResourceiv, "glGetProgramResourceiv");
+
+            Support.ShaderStorageBuffer = Loaded;
+        }
+
+        if (IsGlVersionAtLeast(4, 1) || IsGlExtensionSupported("GL_ARB_separate_shader_objects"))
+        {
+            bool Loaded = true;
+            Loaded &= LoadProc(Load, glext_glProgramParameteri, "glProgramParameteri");
+            Loaded &= LoadProc(Load, glext_glGenProgramPipelines, "glGenProgramPipelines");
+            Loaded &= LoadProc(Load, glext_glDeleteProgramPipelines, "glDeleteProgramPipelines");
+            Loaded &= LoadProc(Load, glext_glBindProgramPipeline, "glBindProgramPipeline");
+            Loaded &= LoadProc(Load, glext_glUseProgramStages, "glUseProgramStages");
+            Loaded &= LoadProc(Load, glext_glActiveShaderProgram, "glActiveShaderProgram");
+            Loaded &= LoadProc(Load, glext_glValidateProgramPipeline, "glValidateProgramPipeline");
+            Loaded &= LoadProc(Load, glext_glGetProgramPipelineiv, "glGetProgramPipelineiv");
+            Loaded &= LoadProc(Load, glext_glGetProgramPipelineInfoLog, "glGetProgramPipelineInfoLog");
+
+            Support.SeparateShaderObjects = Loaded;
+        }
+
+        //the EXT versions of these take the same arguments, they just have a suffix
+        const char* Suffix = nullptr;
+        if (IsGlVersionAtLeast(4, 1) || IsGlExtensionSupported("GL_ARB_separate_shader_objects"))
+            Suffix = "";
+        else if (IsGlExtensionSupported("GL_EXT_direct_state_access"))
+            Suffix = "EXT";
+
+        if (Suffix != nullptr)
+        {
+            bool Loaded = true;
+            Loaded &= LoadProc(Load, glext_glProgramUniform1iv, "glProgramUniform1iv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform1uiv, "glProgramUniform1uiv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform1fv, "glProgramUniform1fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform2iv, "glProgramUniform2iv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform2uiv, "glProgramUniform2uiv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform2fv, "glProgramUniform2fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform3iv, "glProgramUniform3iv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform3uiv, "glProgramUniform3uiv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform3fv, "glProgramUniform3fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform4iv, "glProgramUniform4iv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform4uiv, "glProgramUniform4uiv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniform4fv, "glProgramUniform4fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix2fv, "glProgramUniformMatrix2fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix3fv, "glProgramUniformMatrix3fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix4fv, "glProgramUniformMatrix4fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix2x3fv, "glProgramUniformMatrix2x3fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix3x2fv, "glProgramUniformMatrix3x2fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix2x4fv, "glProgramUniformMatrix2x4fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix4x2fv, "glProgramUniformMatrix4x2fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix3x4fv, "glProgramUniformMatrix3x4fv", Suffix);
+            Loaded &= LoadProc(Load, glext_glProgramUniformMatrix4x3fv, "glProgramUniformMatrix4x3fv", Suffix);
+
+            Support.ProgramUniform = Loaded;
+        }
+
+        //only glSpecializeShader has the ARB suffix in the extension, glShaderBinary is already core
+        const char* SpirvSuffix = nullptr;
+        if (IsGlVersionAtLeast(4, 6))
+            SpirvSuffix = "";
+        else if (IsGlExtensionSupported("GL_ARB_gl_spirv"))
+            SpirvSuffix = "ARB";
+
+        if (SpirvSuffix != nullptr)
+        {
+            bool Loaded = true;
+            Loaded &= LoadProc(Load, glext_glShaderBinary, "glShaderBinary");
+            Loaded &= LoadProc(Load, glext_glSpecializeShader, "glSpecializeShader", SpirvSuffix);
+            Support.Spirv = Loaded;
+        }
+    }
+
+    const GlExtensionSupport& GetGlExtensions()
+    {
+        return Support;
+    }
+
+    bool IsGlExtensionSupported(const char* Name)
+    {
+        GLint ExtensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &ExtensionCount);
+
+        for (GLint i = 0; i < ExtensionCount; i++)
+        {
+            const char* Extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (Extension && std::strcmp(Extension, Name) == 0)
+                return true;
+        }
+
+        return false;
+    }
+}
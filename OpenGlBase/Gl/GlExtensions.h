@@ -0,0 +1,261 @@
+#pragma once
+#include <glad/glad.h>
+
+//glad is generated for the 3.3 core profile, anything newer we use is declared and loaded here
+//in the same style, every entry point stays null when the driver doesn't provide it so check
+//GetGlExtensions() before calling
+
+//GL 4.1 / GL_ARB_get_program_binary
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+extern PFNGLGETPROGRAMBINARYPROC glext_glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glext_glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glext_glProgramParameteri;
+
+#define glGetProgramBinary glext_glGetProgramBinary
+#define glProgramBinary glext_glProgramBinary
+#define glProgramParameteri glext_glProgramParameteri
+
+//GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile, both use the same enums
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glext_glMaxShaderCompilerThreadsKHR;
+
+#define glMaxShaderCompilerThreadsKHR glext_glMaxShaderCompilerThreadsKHR
+
+//GL 4.4 / GL_ARB_buffer_storage
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+extern PFNGLBUFFERSTORAGEPROC glext_glBufferStorage;
+
+#define glBufferStorage glext_glBufferStorage
+
+//GL 4.2 / GL_ARB_shader_image_load_store, only the barrier is used
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#define GL_ELEMENT_ARRAY_BARRIER_BIT 0x00000002
+#define GL_UNIFORM_BARRIER_BIT 0x00000004
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#define GL_PIXEL_BUFFER_BARRIER_BIT 0x00000080
+#define GL_TEXTURE_UPDATE_BARRIER_BIT 0x00000100
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#define GL_FRAMEBUFFER_BARRIER_BIT 0x00000400
+#define GL_TRANSFORM_FEEDBACK_BARRIER_BIT 0x00000800
+#define GL_ATOMIC_COUNTER_BARRIER_BIT 0x00001000
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#define GL_ALL_BARRIER_BITS 0xFFFFFFFF
+
+typedef void (APIENTRYP PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
+
+extern PFNGLMEMORYBARRIERPROC glext_glMemoryBarrier;
+
+#define glMemoryBarrier glext_glMemoryBarrier
+
+//GL 4.3 / GL_ARB_compute_shader
+#define GL_COMPUTE_SHADER 0x91B9
+#define GL_COMPUTE_WORK_GROUP_SIZE 0x8267
+#define GL_MAX_COMPUTE_WORK_GROUP_COUNT 0x91BE
+#define GL_MAX_COMPUTE_WORK_GROUP_SIZE 0x91BF
+#define GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS 0x90EB
+#define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
+
+typedef void (APIENTRYP PFNGLDISPATCHCOMPUTEPROC)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+typedef void (APIENTRYP PFNGLDISPATCHCOMPUTEINDIRECTPROC)(GLintptr indirect);
+
+extern PFNGLDISPATCHCOMPUTEPROC glext_glDispatchCompute;
+extern PFNGLDISPATCHCOMPUTEINDIRECTPROC glext_glDispatchComputeIndirect;
+
+#define glDispatchCompute glext_glDispatchCompute
+#define glDispatchComputeIndirect glext_glDispatchComputeIndirect
+
+//GL 4.3 / GL_ARB_shader_storage_buffer_object with GL_ARB_program_interface_query to reflect the blocks
+//and the locations of uniforms SPIR-V left without names
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
+#define GL_SHADER_STORAGE_BLOCK 0x92E6
+#define GL_ACTIVE_RESOURCES 0x92F5
+#define GL_MAX_NAME_LENGTH 0x92F6
+#define GL_NAME_LENGTH 0x92F9
+#define GL_BUFFER_BINDING 0x9302
+#define GL_BUFFER_DATA_SIZE 0x9303
+#define GL_BUFFER_VARIABLE 0x92E5
+#define GL_TYPE 0x92FA
+#define GL_ARRAY_SIZE 0x92FB
+#define GL_OFFSET 0x92FC
+#define GL_ARRAY_STRIDE 0x92FE
+#define GL_MATRIX_STRIDE 0x92FF
+#define GL_IS_ROW_MAJOR 0x9300
+#define GL_NUM_ACTIVE_VARIABLES 0x9304
+#define GL_ACTIVE_VARIABLES 0x9305
+#define GL_UNIFORM 0x92E1
+#define GL_LOCATION 0x930E
+
+typedef void (APIENTRYP PFNGLSHADERSTORAGEBLOCKBINDINGPROC)(GLuint program, GLuint storageBlockIndex, GLuint storageBlockBinding);
+typedef void (APIENTRYP PFNGLGETPROGRAMINTERFACEIVPROC)(GLuint program, GLenum programInterface, GLenum pname, GLint* params);
+typedef void (APIENTRYP PFNGLGETPROGRAMRESOURCENAMEPROC)(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name);
+typedef void (APIENTRYP PFNGLGETPROGRAMRESOURCEIVPROC)(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params);
+
+extern PFNGLSHADERSTORAGEBLOCKBINDINGPROC glext_glShaderStorageBlockBinding;
+extern PFNGLGETPROGRAMINTERFACEIVPROC glext_glGetProgramInterfaceiv;
+extern PFNGLGETPROGRAMRESOURCENAMEPROC glext_glGetProgramResourceName;
+extern PFNGLGETPROGRAMRESOURCEIVPROC glext_glGetProgramResourceiv;
+
+#define glShaderStorageBlockBinding glext_glShaderStorageBlockBinding
+#define glGetProgramInterfaceiv glext_glGetProgramInterfaceiv
+#define glGetProgramResourceName glext_glGetProgramResourceName
+#define glGetProgramResourceiv glext_glGetProgramResourceiv
+
+//GL 4.1 / GL_ARB_separate_shader_objects, glProgramParameteri is shared with the binary cache
+#define GL_PROGRAM_SEPARABLE 0x8258
+#define GL_ACTIVE_PROGRAM 0x8259
+#define GL_PROGRAM_PIPELINE_BINDING 0x825A
+#define GL_VERTEX_SHADER_BIT 0x00000001
+#define GL_FRAGMENT_SHADER_BIT 0x00000002
+#define GL_GEOMETRY_SHADER_BIT 0x00000004
+#define GL_COMPUTE_SHADER_BIT 0x00000020
+#define GL_ALL_SHADER_BITS 0xFFFFFFFF
+
+typedef void (APIENTRYP PFNGLGENPROGRAMPIPELINESPROC)(GLsizei n, GLuint* pipelines);
+typedef void (APIENTRYP PFNGLDELETEPROGRAMPIPELINESPROC)(GLsizei n, const GLuint* pipelines);
+typedef void (APIENTRYP PFNGLBINDPROGRAMPIPELINEPROC)(GLuint pipeline);
+typedef void (APIENTRYP PFNGLUSEPROGRAMSTAGESPROC)(GLuint pipeline, GLbitfield stages, GLuint program);
+typedef void (APIENTRYP PFNGLACTIVESHADERPROGRAMPROC)(GLuint pipeline, GLuint program);
+typedef void (APIENTRYP PFNGLVALIDATEPROGRAMPIPELINEPROC)(GLuint pipeline);
+typedef void (APIENTRYP PFNGLGETPROGRAMPIPELINEIVPROC)(GLuint pipeline, GLenum pname, GLint* params);
+typedef void (APIENTRYP PFNGLGETPROGRAMPIPELINEINFOLOGPROC)(GLuint pipeline, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+
+extern PFNGLGENPROGRAMPIPELINESPROC glext_glGenProgramPipelines;
+extern PFNGLDELETEPROGRAMPIPELINESPROC glext_glDeleteProgramPipelines;
+extern PFNGLBINDPROGRAMPIPELINEPROC glext_glBindProgramPipeline;
+extern PFNGLUSEPROGRAMSTAGESPROC glext_glUseProgramStages;
+extern PFNGLACTIVESHADERPROGRAMPROC glext_glActiveShaderProgram;
+extern PFNGLVALIDATEPROGRAMPIPELINEPROC glext_glValidateProgramPipeline;
+extern PFNGLGETPROGRAMPIPELINEIVPROC glext_glGetProgramPipelineiv;
+extern PFNGLGETPROGRAMPIPELINEINFOLOGPROC glext_glGetProgramPipelineInfoLog;
+
+#define glGenProgramPipelines glext_glGenProgramPipelines
+#define glDeleteProgramPipelines glext_glDeleteProgramPipelines
+#define glBindProgramPipeline glext_glBindProgramPipeline
+#define glUseProgramStages glext_glUseProgramStages
+#define glActiveShaderProgram glext_glActiveShaderProgram
+#define glValidateProgramPipeline glext_glValidateProgramPipeline
+#define glGetProgramPipelineiv glext_glGetProgramPipelineiv
+#define glGetProgramPipelineInfoLog glext_glGetProgramPipelineInfoLog
+
+//GL 4.1 / GL_ARB_separate_shader_objects or GL_EXT_direct_state_access, only the array forms are
+//loaded since a single value is just an array of one
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM1IVPROC)(GLuint program, GLint location, GLsizei count, const GLint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM1UIVPROC)(GLuint program, GLint location, GLsizei count, const GLuint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM1FVPROC)(GLuint program, GLint location, GLsizei count, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM2IVPROC)(GLuint program, GLint location, GLsizei count, const GLint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM2UIVPROC)(GLuint program, GLint location, GLsizei count, const GLuint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM2FVPROC)(GLuint program, GLint location, GLsizei count, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM3IVPROC)(GLuint program, GLint location, GLsizei count, const GLint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM3UIVPROC)(GLuint program, GLint location, GLsizei count, const GLuint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM3FVPROC)(GLuint program, GLint location, GLsizei count, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM4IVPROC)(GLuint program, GLint location, GLsizei count, const GLint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM4UIVPROC)(GLuint program, GLint location, GLsizei count, const GLuint* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORM4FVPROC)(GLuint program, GLint location, GLsizei count, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX2FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX3FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX4FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX2X3FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX3X2FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX2X4FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX4X2FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX3X4FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (APIENTRYP PFNGLPROGRAMUNIFORMMATRIX4X3FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+extern PFNGLPROGRAMUNIFORM1IVPROC glext_glProgramUniform1iv;
+extern PFNGLPROGRAMUNIFORM1UIVPROC glext_glProgramUniform1uiv;
+extern PFNGLPROGRAMUNIFORM1FVPROC glext_glProgramUniform1fv;
+extern PFNGLPROGRAMUNIFORM2IVPROC glext_glProgramUniform2iv;
+extern PFNGLPROGRAMUNIFORM2UIVPROC glext_glProgramUniform2uiv;
+extern PFNGLPROGRAMUNIFORM2FVPROC glext_glProgramUniform2fv;
+extern PFNGLPROGRAMUNIFORM3IVPROC glext_glProgramUniform3iv;
+extern PFNGLPROGRAMUNIFORM3UIVPROC glext_glProgramUniform3uiv;
+extern PFNGLPROGRAMUNIFORM3FVPROC glext_glProgramUniform3fv;
+extern PFNGLPROGRAMUNIFORM4IVPROC glext_glProgramUniform4iv;
+extern PFNGLPROGRAMUNIFORM4UIVPROC glext_glProgramUniform4uiv;
+extern PFNGLPROGRAMUNIFORM4FVPROC glext_glProgramUniform4fv;
+extern PFNGLPROGRAMUNIFORMMATRIX2FVPROC glext_glProgramUniformMatrix2fv;
+extern PFNGLPROGRAMUNIFORMMATRIX3FVPROC glext_glProgramUniformMatrix3fv;
+extern PFNGLPROGRAMUNIFORMMATRIX4FVPROC glext_glProgramUniformMatrix4fv;
+extern PFNGLPROGRAMUNIFORMMATRIX2X3FVPROC glext_glProgramUniformMatrix2x3fv;
+extern PFNGLPROGRAMUNIFORMMATRIX3X2FVPROC glext_glProgramUniformMatrix3x2fv;
+extern PFNGLPROGRAMUNIFORMMATRIX2X4FVPROC glext_glProgramUniformMatrix2x4fv;
+extern PFNGLPROGRAMUNIFORMMATRIX4X2FVPROC glext_glProgramUniformMatrix4x2fv;
+extern PFNGLPROGRAMUNIFORMMATRIX3X4FVPROC glext_glProgramUniformMatrix3x4fv;
+extern PFNGLPROGRAMUNIFORMMATRIX4X3FVPROC glext_glProgramUniformMatrix4x3fv;
+
+#define glProgramUniform1iv glext_glProgramUniform1iv
+#define glProgramUniform1uiv glext_glProgramUniform1uiv
+#define glProgramUniform1fv glext_glProgramUniform1fv
+#define glProgramUniform2iv glext_glProgramUniform2iv
+#define glProgramUniform2uiv glext_glProgramUniform2uiv
+#define glProgramUniform2fv glext_glProgramUniform2fv
+#define glProgramUniform3iv glext_glProgramUniform3iv
+#define glProgramUniform3uiv glext_glProgramUniform3uiv
+#define glProgramUniform3fv glext_glProgramUniform3fv
+#define glProgramUniform4iv glext_glProgramUniform4iv
+#define glProgramUniform4uiv glext_glProgramUniform4uiv
+#define glProgramUniform4fv glext_glProgramUniform4fv
+#define glProgramUniformMatrix2fv glext_glProgramUniformMatrix2fv
+#define glProgramUniformMatrix3fv glext_glProgramUniformMatrix3fv
+#define glProgramUniformMatrix4fv glext_glProgramUniformMatrix4fv
+#define glProgramUniformMatrix2x3fv glext_glProgramUniformMatrix2x3fv
+#define glProgramUniformMatrix3x2fv glext_glProgramUniformMatrix3x2fv
+#define glProgramUniformMatrix2x4fv glext_glProgramUniformMatrix2x4fv
+#define glProgramUniformMatrix4x2fv glext_glProgramUniformMatrix4x2fv
+#define glProgramUniformMatrix3x4fv glext_glProgramUniformMatrix3x4fv
+#define glProgramUniformMatrix4x3fv glext_glProgramUniformMatrix4x3fv
+
+//GL 4.6 / GL_ARB_gl_spirv, glShaderBinary itself is GL 4.1 which ARB_gl_spirv requires anyway
+#define GL_SHADER_BINARY_FORMAT_SPIR_V 0x9551
+#define GL_SPIR_V_BINARY 0x9552
+
+typedef void (APIENTRYP PFNGLSHADERBINARYPROC)(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLSPECIALIZESHADERPROC)(GLuint shader, const GLchar* pEntryPoint, GLuint numSpecializationConstants, const GLuint* pConstantIndex, const GLuint* pConstantValue);
+
+extern PFNGLSHADERBINARYPROC glext_glShaderBinary;
+extern PFNGLSPECIALIZESHADERPROC glext_glSpecializeShader;
+
+#define glShaderBinary glext_glShaderBinary
+#define glSpecializeShader glext_glSpecializeShader
+
+namespace Base
+{
+    struct GlExtensionSupport
+    {
+        bool ProgramBinary = false;
+        bool ParallelShaderCompile = false;
+        bool BufferStorage = false;
+        bool MemoryBarriers = false;
+        bool ComputeShader = false;
+        bool ShaderStorageBuffer = false;
+        bool SeparateShaderObjects = false;
+        bool ProgramUniform = false;
+        bool Spirv = false;
+    };
+
+    //needs a current context, called by Window after glad has been loaded
+    void LoadGlExtensions(GLADloadproc Load);
+    const GlExtensionSupport& GetGlExtensions();
+    bool IsGlExtensionSupported(const char* Name);
+}
@@ -0,0 +1,219 @@
+#include "ShaderArchive.h"
+#include "../Debug/Log.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+namespace Base
+{
+    //walks the archive data, every read fails once the end has been passed so truncated files are caught
+    struct ArchiveReader
+    {
+        const std::string& Data;
+        std::size_t Offset = 0;
+
+        bool Read(void* Destination, std::size_t Size)
+        {
+            if (Size > Data.size() - Offset)
+                return false;
+
+            std::memcpy(Destination, Data.data() + Offset, Size);
+            Offset += Size;
+            return true;
+        }
+
+        bool ReadU32(u32& Value)
+        {
+            return Read(&Value, sizeof(Value));
+        }
+
+        bool ReadString(std::string& String)
+        {
+            u32 Length = 0;
+            if (!ReadU32(Length) || Length > Data.size() - Offset)
+                return false;
+
+            String.assign(Data.data() + Offset, Length);
+            Offset += Length;
+            return true;
+        }
+
+        bool ReadWords(std::vector<u32>& Words)
+        {
+            u32 Count = 0;
+            if (!ReadU32(Count) || Count > (Data.size() - Offset) / sizeof(u32))
+                return false;
+
+            Words.resize(Count);
+            return Read(Words.data(), Count * sizeof(u32));
+        }
+    };
+
+    static void WriteU32(std::string& Data, u32 Value)
+    {
+        Data.append(reinterpret_cast<const char*>(&Value), sizeof(Value));
+    }
+
+    ShaderProgramConfig ShaderArchiveEntry::GetConfig(const char* CacheDirectory) const
+    {
+        auto GetSource = [&](u32 Stage) -> const char*
+        {
+            return Sources[Stage].empty() ? nullptr : Sources[Stage].c_str();
+        };
+
+        auto GetModule = [&](u32 Stage) -> ShaderSpirvModule
+        {
+            return { Spirv[Stage].empty() ? nullptr : Spirv[Stage].data(), Spirv[Stage].size() };
+        };
+
+        ShaderProgramConfig Config = {};
+        Config.VertexSource = GetSource(0);
+        Config.FragmentSource = GetSource(1);
+        Config.GeometrySource = GetSource(2);
+        Config.ComputeSource = GetSource(3);
+        Config.CacheDirectory = CacheDirectory;
+        Config.Separable = Separable;
+        Config.VertexSpirv = GetModule(0);
+        Config.FragmentSpirv = GetModule(1);
+        Config.GeometrySpirv = GetModule(2);
+        Config.ComputeSpirv = GetModule(3);
+
+        return Config;
+    }
+
+    void ShaderArchive::Add(ShaderArchiveEntry Entry)
+    {
+        auto Iterator = EntryIndices.find(Entry.Name);
+        if (Iterator != EntryIndices.end())
+        {
+            Entries[Iterator->second] = std::move(Entry);
+            return;
+        }
+
+        EntryIndices[Entry.Name] = Entries.size();
+        Entries.push_back(std::move(Entry));
+    }
+
+    const ShaderArchiveEntry* ShaderArchive::Find(const std::string& Name) const
+    {
+        auto Iterator = EntryIndices.find(Name);
+        if (Iterator == EntryIndices.end())
+            return nullptr;
+
+        return &Entries[Iterator->second];
+    }
+
+    const std::vector<ShaderArchiveEntry>& ShaderArchive::GetEntries() const
+    {
+        return Entries;
+    }
+
+    bool ShaderArchive::Load(VirtualFileSystem& FileSystem, const std::string& Path)
+    {
+        Entries.clear();
+        EntryIndices.clear();
+
+        std::string Data;
+        if (!FileSystem.ReadFile(Path, Data))
+        {
+            Log::Error<LogCategory::Shader>("Failed to read shader archive {}", Path);
+            return false;
+        }
+
+        if (!Parse(Data))
+        {
+            Log::Error<LogCategory::Shader>("Shader archive {} is corrupt or from another version", Path);
+
+            Entries.clear();
+            EntryIndices.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ShaderArchive::Parse(const std::string& Data)
+    {
+        ArchiveReader Reader{ Data };
+
+        u32 Magic = 0;
+        u32 Version = 0;
+        u32 EntryCount = 0;
+
+        if (!Reader.ReadU32(Magic) || !Reader.ReadU32(Version) || !Reader.ReadU32(EntryCount))
+            return false;
+
+        if (Magic != ExpectedMagic || Version != ExpectedVersion)
+            return false;
+
+        for (u32 i = 0; i < EntryCount; i++)
+        {
+            ShaderArchiveEntry Entry;
+
+            u32 Separable = 0;
+            if (!Reader.ReadString(Entry.Name) || !Reader.ReadU32(Separable))
+                return false;
+
+            Entry.Separable = Separable != 0;
+
+            for (u32 Stage = 0; Stage < 4; Stage++)
+            {
+                if (!Reader.ReadString(Entry.Sources[Stage]) || !Reader.ReadWords(Entry.Spirv[Stage]))
+                    return false;
+            }
+
+            Add(std::move(Entry));
+        }
+
+        return Reader.Offset == Data.size();
+    }
+
+    bool ShaderArchive::Save(const std::string& FullPath) const
+    {
+        std::string Data;
+        WriteU32(Data, ExpectedMagic);
+        WriteU32(Data, ExpectedVersion);
+        WriteU32(Data, static_cast<u32>(Entries.size()));
+
+        for (const ShaderArchiveEntry& Entry : Entries)
+        {
+            WriteU32(Data, static_cast<u32>(Entry.Name.size()));
+            Data += Entry.Name;
+            WriteU32(Data, Entry.Separable ? 1 : 0);
+
+            for (u32 Stage = 0; Stage < 4; Stage++)
+            {
+                WriteU32(Data, static_cast<u32>(Entry.Sources[Stage].size()));
+                Data += Entry.Sources[Stage];
+
+                WriteU32(Data, static_cast<u32>(Entry.Spirv[Stage].size()));
+                Data.append(reinterpret_cast<const char*>(Entry.Spirv[Stage].data()), Entry.Spirv[Stage].size() * sizeof(u32));
+            }
+        }
+
+        //same as the program binary cache, a failed build never leaves a half written archive behind
+        std::filesystem::path Path = FullPath;
+        std::filesystem::path TempPath = Path;
+        TempPath += ".tmp";
+
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            if (!File || !File.write(Data.data(), Data.size()))
+            {
+                Log::Error<LogCategory::Shader>("Failed to write shader archive {}", TempPath.string());
+                return false;
+            }
+        }
+
+        std::error_code Error;
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            Log::Error<LogCategory::Shader>("Failed to write shader archive {}: {}", Path.string(), Error.message());
+            std::filesystem::remove(TempPath, Error);
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ShaderManager.h"
+#include "../FileSystem/VirtualFileSystem.h"
+
+namespace Base
+{
+    //one cooked program, stages are in vertex, fragment, geometry, compute order and empty when unused
+    struct ShaderArchiveEntry
+    {
+        std::string Name;
+
+        //fully preprocessed GLSL, includes expanded and defines injected, ready to hand to the driver
+        std::string Sources[4];
+
+        //only filled in when the cook was asked for SPIR-V
+        std::vector<u32> Spirv[4];
+
+        bool Separable = false;
+
+        //points into the entry, which has to outlive the build
+        ShaderProgramConfig GetConfig(const char* CacheDirectory = nullptr) const;
+    };
+
+    //a packed set of programs written by the ShaderCook tool at asset build time, so nothing has to be
+    //read, preprocessed or validated at startup
+    //
+    //the file is a header followed by the entries back to back, every string and module is prefixed
+    //by its length as a u32. it is written in the byte order of the machine that cooked it
+    class ShaderArchive
+    {
+    public:
+        ShaderArchive() = default;
+
+        //replaces an entry with the same name
+        void Add(ShaderArchiveEntry Entry);
+
+        const ShaderArchiveEntry* Find(const std::string& Name) const;
+        const std::vector<ShaderArchiveEntry>& GetEntries() const;
+
+        //false if the file is missing, truncated or from another version, the archive is left empty then
+        bool Load(VirtualFileSystem& FileSystem, const std::string& Path);
+        bool Save(const std::string& FullPath) const;
+
+    private:
+        static constexpr u32 ExpectedMagic = 0x41534C47; //"GLSA"
+        static constexpr u32 ExpectedVersion = 1;
+
+        std::vector<ShaderArchiveEntry> Entries;
+        std::unordered_map<std::string, std::size_t> EntryIndices;
+
+        bool Parse(const std::string& Data);
+    };
+}
@@ -0,0 +1,150 @@
+#include "ShaderCompileQueue.h"
+#include "../Gl/GlExtensions.h"
+#include <algorithm>
+
+namespace Base
+{
+    PendingShaderProgram::~PendingShaderProgram()
+    {
+        //dropped or destroyed before it finished, the GL objects are still ours
+        if (State == PendingShaderState::Compiling)
+            ShaderProgram::AbandonBuild(Build);
+    }
+
+    PendingShaderState PendingShaderProgram::GetState() const
+    {
+        return State;
+    }
+
+    bool PendingShaderProgram::IsDone() const
+    {
+        return State != PendingShaderState::Compiling;
+    }
+
+    const std::string& PendingShaderProgram::GetInfoLog() const
+    {
+        return Build.InfoLog;
+    }
+
+    ShaderProgram* PendingShaderProgram::Get() const
+    {
+        return Program.get();
+    }
+
+    std::unique_ptr<ShaderProgram> PendingShaderProgram::Release()
+    {
+        return std::move(Program);
+    }
+
+    ShaderCompileQueue::ShaderCompileQueue(const ShaderCompileQueueConfig& QueueConfig)
+        : Config(QueueConfig)
+    {
+        assert(Config.MaxFinishedPerPoll > 0);
+
+        ParallelCompile = GetGlExtensions().ParallelShaderCompile;
+
+        //0xFFFFFFFF lets the driver pick how many threads to use
+        if (ParallelCompile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+
+    ShaderCompileQueue::~ShaderCompileQueue()
+    {
+        Flush();
+    }
+
+    std::shared_ptr<PendingShaderProgram> ShaderCompileQueue::Submit(const ShaderProgramConfig& ProgramConfig)
+    {
+        std::shared_ptr<PendingShaderProgram> Handle = std::make_shared<PendingShaderProgram>();
+        Handle->Build = ShaderProgram::BeginBuild(ProgramConfig);
+        Handle->SubmitPoll = PollCount;
+
+        //a program binary cache hit is already linked, nothing to wait for
+        if (Handle->Build.LoadedFromCache)
+            Finish(*Handle);
+        else
+            Pending.push_back(Handle);
+
+        return Handle;
+    }
+
+    void ShaderCompileQueue::Poll()
+    {
+        PollCount++;
+
+        u32 FinishedCount = 0;
+
+        auto IsFinished = [&](const std::shared_ptr<PendingShaderProgram>& Handle)
+        {
+            if (ParallelCompile)
+            {
+                if (!IsBuildComplete(Handle->Build))
+                    return false;
+            }
+            else
+            {
+                //deferred mode, give the driver at least one frame and only finish a few per poll
+                //since each status check may block until that program is linked
+                if (Handle->SubmitPoll + 1 >= PollCount || FinishedCount >= Config.MaxFinishedPerPoll)
+                    return false;
+
+                FinishedCount++;
+            }
+
+            Finish(*Handle);
+            return true;
+        };
+
+        Pending.erase(std::remove_if(Pending.begin(), Pending.end(), IsFinished), Pending.end());
+    }
+
+    void ShaderCompileQueue::Flush()
+    {
+        for (std::shared_ptr<PendingShaderProgram>& Handle : Pending)
+            Finish(*Handle);
+
+        Pending.clear();
+    }
+
+    void ShaderCompileQueue::Wait(const std::shared_ptr<PendingShaderProgram>& Handle)
+    {
+        auto Iterator = std::find(Pending.begin(), Pending.end(), Handle);
+        if (Iterator == Pending.end())
+            return;
+
+        Finish(*Handle);
+        Pending.erase(Iterator);
+    }
+
+    std::size_t ShaderCompileQueue::GetPendingCount() const
+    {
+        return Pending.size();
+    }
+
+    bool ShaderCompileQueue::IsParallelCompileSupported() const
+    {
+        return ParallelCompile;
+    }
+
+    bool ShaderCompileQueue::IsBuildComplete(const ShaderProgram::Build& Build)
+    {
+        //the link can only complete after every attached stage has, so the program status covers them all
+        GLint Complete = GL_FALSE;
+        glGetProgramiv(Build.Program, GL_COMPLETION_STATUS_KHR, &Complete);
+
+        return Complete == GL_TRUE;
+    }
+
+    void ShaderCompileQueue::Finish(PendingShaderProgram& Handle)
+    {
+        if (ShaderProgram::FinishBuild(Handle.Build))
+        {
+            Handle.Program = std::unique_ptr<ShaderProgram>(new ShaderProgram(Handle.Build));
+            Handle.State = PendingShaderState::Ready;
+        }
+        else
+        {
+            ShaderProgram::AbandonBuild(Handle.Build);
+            Handle.State = PendingShaderState::Failed;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "ShaderManager.h"
+
+namespace Base
+{
+    enum class PendingShaderState
+    {
+        Compiling,
+        Ready,
+        Failed,
+    };
+
+    //handle returned by ShaderCompileQueue::Submit, the program becomes available once the queue
+    //has seen it finish during a Poll
+    class PendingShaderProgram
+    {
+    public:
+        PendingShaderProgram(const PendingShaderProgram&) = delete;
+        PendingShaderProgram& operator=(const PendingShaderProgram&) = delete;
+
+        PendingShaderProgram() = default;
+        ~PendingShaderProgram();
+
+        PendingShaderState GetState() const;
+        bool IsDone() const;
+
+        //null until the state is Ready
+        ShaderProgram* Get() const;
+
+        //compile and link errors once the state is Failed
+        const std::string& GetInfoLog() const;
+        std::unique_ptr<ShaderProgram> Release();
+
+    private:
+        friend class ShaderCompileQueue;
+
+        ShaderProgram::Build Build;
+        std::unique_ptr<ShaderProgram> Program;
+        PendingShaderState State = PendingShaderState::Compiling;
+        u64 SubmitPoll = 0;
+    };
+
+    struct ShaderCompileQueueConfig
+    {
+        //without GL_KHR_parallel_shader_compile checking a status can block until the driver is done,
+        //so at most this many programs are finished per Poll
+        u32 MaxFinishedPerPoll = 4;
+    };
+
+    //submits every stage and the link up front and only checks on them from Poll, which is meant to run
+    //once per frame, for example through Window::AddTickCallback
+    class ShaderCompileQueue
+    {
+    public:
+        ShaderCompileQueue(const ShaderCompileQueue&) = delete;
+        ShaderCompileQueue& operator=(const ShaderCompileQueue&) = delete;
+
+        ShaderCompileQueue(const ShaderCompileQueueConfig& QueueConfig = {});
+
+        //finishes whatever is still pending so no handle is left waiting on a queue that's gone
+        ~ShaderCompileQueue();
+
+        std::shared_ptr<PendingShaderProgram> Submit(const ShaderProgramConfig& Config);
+
+        void Poll();
+
+        //blocks until every submitted program is finished
+        void Flush();
+
+        //blocks until just this program is finished
+        void Wait(const std::shared_ptr<PendingShaderProgram>& Handle);
+
+        std::size_t GetPendingCount() const;
+        bool IsParallelCompileSupported() const;
+
+    private:
+        std::vector<std::shared_ptr<PendingShaderProgram>> Pending;
+        ShaderCompileQueueConfig Config;
+        bool ParallelCompile = false;
+        u64 PollCount = 0;
+
+        static bool IsBuildComplete(const ShaderProgram::Build& Build);
+        static void Finish(PendingShaderProgram& Program);
+    };
+}
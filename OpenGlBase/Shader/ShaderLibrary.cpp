@@ -0,0 +1,200 @@
+#include "ShaderLibrary.h"
+#include "../Util/Hash.h"
+#include "../Debug/Log.h"
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+namespace Base
+{
+    ShaderLibrary::ShaderLibrary(DiskFileSystem& FileSystem, ShaderPreprocessor& Preprocessor, ShaderCompileQueue& Queue, const ShaderLibraryConfig& LibraryConfig)
+        : FileSystem(FileSystem), Preprocessor(Preprocessor), Queue(Queue), Config(LibraryConfig)
+    {
+        if (Config.HotReload)
+            Watcher = std::make_unique<FileWatcher>(Config.Watcher);
+    }
+
+    ShaderProgram* ShaderLibrary::Load(const std::string& Name, const ShaderSourceFiles& Files)
+    {
+        assert(Entries.find(Name) == Entries.end() && "Shader already loaded");
+
+        PreprocessedSources Preprocessed;
+        if (!Preprocess(Files, Preprocessed))
+            return nullptr;
+
+        std::unique_ptr<ShaderProgram> Program = ShaderProgram::TryCreate(GetProgramConfig(Files, Preprocessed));
+        if (!Program)
+            return nullptr;
+
+        Entry& Current = Entries[Name];
+        Current.Files = Files;
+        Current.Program = std::move(Program);
+        Current.SourceHash = Preprocessed.Hash;
+
+        SetDependencies(Name, Current, std::move(Preprocessed.Dependencies));
+
+        return Current.Program.get();
+    }
+
+    ShaderProgram* ShaderLibrary::Get(const std::string& Name) const
+    {
+        auto Iterator = Entries.find(Name);
+        if (Iterator == Entries.end())
+            return nullptr;
+
+        return Iterator->second.Program.get();
+    }
+
+    void ShaderLibrary::Tick()
+    {
+        if (Watcher)
+        {
+            for (const std::string& FullPath : Watcher->TakeChangedFiles())
+            {
+                auto Path = WatchedPaths.find(FullPath);
+                if (Path == WatchedPaths.end())
+                    continue;
+
+                Preprocessor.InvalidateFile(Path->second);
+
+                for (const std::string& Name : Dependents[Path->second])
+                    Entries[Name].Dirty = true;
+            }
+        }
+
+        for (auto& [Name, Current] : Entries)
+        {
+            if (Current.Pending && Current.Pending->IsDone())
+                FinishRebuild(Name, Current);
+
+            //wait for the current rebuild before starting another so they finish in order
+            if (Current.Dirty && !Current.Pending)
+                SubmitRebuild(Name, Current);
+        }
+    }
+
+    const std::string& ShaderLibrary::GetReloadError(const std::string& Name) const
+    {
+        static const std::string Empty;
+
+        auto Iterator = Entries.find(Name);
+        if (Iterator == Entries.end())
+            return Empty;
+
+        return Iterator->second.ReloadError;
+    }
+
+    void ShaderLibrary::SetReloadCallback(ReloadCallback Callback)
+    {
+        OnReload = std::move(Callback);
+    }
+
+    bool ShaderLibrary::Preprocess(const ShaderSourceFiles& Files, PreprocessedSources& Result)
+    {
+        const std::string* Paths[] = { &Files.VertexPath, &Files.FragmentPath, &Files.GeometryPath, &Files.ComputePath };
+
+        Result.Hash = HashOffsetBasis;
+
+        for (std::size_t i = 0; i < std::size(Paths); i++)
+        {
+            if (Paths[i]->empty())
+                continue;
+
+            const PreprocessedShader* Shader = Preprocessor.PreprocessFile(*Paths[i], Files.Defines);
+            if (!Shader)
+            {
+                Log::Warning<LogCategory::Shader>("Failed to preprocess shader {}", *Paths[i]);
+                return false;
+            }
+
+            Result.Sources[i] = Shader->Source;
+            Result.Hash = HashBytes(&Shader->Hash, sizeof(Shader->Hash), Result.Hash);
+            Result.Dependencies.insert(Result.Dependencies.end(), Shader->Files.begin(), Shader->Files.end());
+        }
+
+        std::sort(Result.Dependencies.begin(), Result.Dependencies.end());
+        Result.Dependencies.erase(std::unique(Result.Dependencies.begin(), Result.Dependencies.end()), Result.Dependencies.end());
+
+        return true;
+    }
+
+    ShaderProgramConfig ShaderLibrary::GetProgramConfig(const ShaderSourceFiles& Files, const PreprocessedSources& Preprocessed) const
+    {
+        auto GetSource = [&](const std::string& Path, u32 Stage) -> const char*
+        {
+            return Path.empty() ? nullptr : Preprocessed.Sources[Stage].c_str();
+        };
+
+        ShaderProgramConfig ProgramConfig;
+        ProgramConfig.VertexSource = GetSource(Files.VertexPath, 0);
+        ProgramConfig.FragmentSource = GetSource(Files.FragmentPath, 1);
+        ProgramConfig.GeometrySource = GetSource(Files.GeometryPath, 2);
+        ProgramConfig.ComputeSource = GetSource(Files.ComputePath, 3);
+        ProgramConfig.CacheDirectory = Config.CacheDirectory;
+
+        return ProgramConfig;
+    }
+
+    void ShaderLibrary::SetDependencies(const std::string& Name, Entry& Current, std::vector<std::string> Dependencies)
+    {
+        for (const std::string& Path : Current.Dependencies)
+            Dependents[Path].erase(Name);
+
+        Current.Dependencies = std::move(Dependencies);
+
+        for (const std::string& Path : Current.Dependencies)
+        {
+            Dependents[Path].insert(Name);
+
+            //files stay watched once seen, an include that was dropped is just ignored on change
+            std::string FullPath = FileSystem.GetFullPath(Path);
+            if (Watcher && WatchedPaths.find(FullPath) == WatchedPaths.end() && Watcher->Watch(FullPath))
+                WatchedPaths[FullPath] = Path;
+        }
+    }
+
+    void ShaderLibrary::SubmitRebuild(const std::string& Name, Entry& Current)
+    {
+        Current.Dirty = false;
+
+        PreprocessedSources Preprocessed;
+        if (!Preprocess(Current.Files, Preprocessed))
+        {
+            //most likely caught the file mid save, the next change event will try again
+            Current.ReloadError = "Failed to preprocess";
+            return;
+        }
+
+        SetDependencies(Name, Current, std::move(Preprocessed.Dependencies));
+
+        if (Preprocessed.Hash == Current.SourceHash)
+            return;
+
+        //the sources only have to outlive Submit, every stage has been handed to the driver by then
+        Current.Pending = Queue.Submit(GetProgramConfig(Current.Files, Preprocessed));
+        Current.SourceHash = Preprocessed.Hash;
+    }
+
+    void ShaderLibrary::FinishRebuild(const std::string& Name, Entry& Current)
+    {
+        std::shared_ptr<PendingShaderProgram> Pending = std::move(Current.Pending);
+
+        if (Pending->GetState() == PendingShaderState::Failed)
+        {
+            Current.ReloadError = Pending->GetInfoLog();
+            Log::Warning<LogCategory::Shader>("Failed to reload shader {}, keeping the previous program", Name);
+
+            //a fix that reverts to the old text still has to rebuild
+            Current.SourceHash = 0;
+            return;
+        }
+
+        //the old program ends up in the released object and is deleted with it
+        std::unique_ptr<ShaderProgram> Rebuilt = Pending->Release();
+        Current.Program->Swap(*Rebuilt);
+        Current.ReloadError.clear();
+
+        if (OnReload)
+            OnReload(Name, *Current.Program);
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ShaderManager.h"
+#include "ShaderCompileQueue.h"
+#include "ShaderPreprocessor.h"
+#include "../FileSystem/VirtualFileSystem.h"
+#include "../FileSystem/FileWatcher.h"
+
+namespace Base
+{
+    //paths are relative to the root of the library's DiskFileSystem, leave unused stages empty,
+    //a compute program sets only ComputePath
+    struct ShaderSourceFiles
+    {
+        std::string VertexPath;
+        std::string FragmentPath;
+        std::string GeometryPath;
+        std::string ComputePath;
+        std::vector<ShaderDefine> Defines;
+    };
+
+    struct ShaderLibraryConfig
+    {
+        const char* CacheDirectory = nullptr;
+        bool HotReload = true;
+        FileWatcherConfig Watcher;
+    };
+
+    //named programs built from files on disk that rebuild themselves when any file they include changes
+    //
+    //a change is picked up by the watcher thread, the rebuild is submitted to the compile queue and the
+    //new program is swapped into the existing ShaderProgram object from Tick once it has linked, so
+    //pointers handed out by Load and Get never change. a rebuild that fails to compile or link leaves
+    //the running program untouched and its info log is printed and kept in GetReloadError
+    //
+    //the preprocessor has to read from the same DiskFileSystem. call Tick once per frame, for example
+    //through Window::AddTickCallback, and keep polling the queue
+    class ShaderLibrary
+    {
+    public:
+        ShaderLibrary(const ShaderLibrary&) = delete;
+        ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+        ShaderLibrary(DiskFileSystem& FileSystem, ShaderPreprocessor& Preprocessor, ShaderCompileQueue& Queue, const ShaderLibraryConfig& LibraryConfig = {});
+        ~ShaderLibrary() = default;
+
+        //compiles right away, null if the files can't be read or the program fails to build
+        ShaderProgram* Load(const std::string& Name, const ShaderSourceFiles& Files);
+        ShaderProgram* Get(const std::string& Name) const;
+
+        //checks for changed files, submits rebuilds and swaps in every rebuild that has finished
+        void Tick();
+
+        //empty when the last reload succeeded
+        const std::string& GetReloadError(const std::string& Name) const;
+
+        //a swapped program starts with every uniform at its default, use this to set up anything that
+        //is normally only set once after loading
+        using ReloadCallback = std::function<void(const std::string& Name, ShaderProgram& Program)>;
+        void SetReloadCallback(ReloadCallback Callback);
+
+    private:
+        struct Entry
+        {
+            ShaderSourceFiles Files;
+            std::unique_ptr<ShaderProgram> Program;
+            std::shared_ptr<PendingShaderProgram> Pending;
+
+            //combined hash of the preprocessed stages, a save that changes nothing doesn't rebuild
+            u64 SourceHash = 0;
+
+            //every file the stages included last time they were preprocessed
+            std::vector<std::string> Dependencies;
+
+            bool Dirty = false;
+            std::string ReloadError;
+        };
+
+        struct PreprocessedSources
+        {
+            std::string Sources[4];
+            std::vector<std::string> Dependencies;
+            u64 Hash = 0;
+        };
+
+        DiskFileSystem& FileSystem;
+        ShaderPreprocessor& Preprocessor;
+        ShaderCompileQueue& Queue;
+        ShaderLibraryConfig Config;
+
+        std::unique_ptr<FileWatcher> Watcher;
+        ReloadCallback OnReload;
+
+        std::unordered_map<std::string, Entry> Entries;
+
+        //full path on disk to the relative path the preprocessor knows it by, and the entries using it
+        std::unordered_map<std::string, std::string> WatchedPaths;
+        std::unordered_map<std::string, std::unordered_set<std::string>> Dependents;
+
+        bool Preprocess(const ShaderSourceFiles& Files, PreprocessedSources& Result);
+        ShaderProgramConfig GetProgramConfig(const ShaderSourceFiles& Files, const PreprocessedSources& Preprocessed) const;
+        void SetDependencies(const std::string& Name, Entry& Current, std::vector<std::string> Dependencies);
+        void SubmitRebuild(const std::string& Name, Entry& Current);
+        void FinishRebuild(const std::string& Name, Entry& Current);
+    };
+}
@@ -1,64 +1,126 @@
 #include "ShaderManager.h"
-#include <iostream>
+#include "ShaderArchive.h"
+#include "../Gl/GlExtensions.h"
+#include "../Debug/Log.h"
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <utility>
 
 
 
 namespace Base
 {
+    //GL state belongs to the context, which is only ever current on one thread
+    //nothing is known until the first bind, the context may have been handed over with a program current
+    static thread_local GLuint BoundProgram = 0;
+    static thread_local bool BoundProgramKnown = false;
+
     ShaderProgram::ShaderProgram(const ShaderProgramConfig& Config)
     {        
-        assert(Config.VertexSource);
-        assert(Config.FragmentSource);
+        Build SyncBuild = BeginBuild(Config);
 
-        GLuint VertexShader = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(VertexShader, 1, &Config.VertexSource, nullptr);
-        glCompileShader(VertexShader);
-        assert(LogShaderCompilationStatus(VertexShader));
+        bool Linked = FinishBuild(SyncBuild);
+        assert(Linked);
 
-        GLuint FragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(FragmentShader, 1, &Config.FragmentSource, nullptr);
-        glCompileShader(FragmentShader);
-        assert(LogShaderCompilationStatus(FragmentShader));
+        Program = SyncBuild.Program;
+        Stages = SyncBuild.Stages;
+        Separable = SyncBuild.Separable;
+        ReflectUniforms();
+    }
 
-        GLuint GeometryShader = 0;
-        if (Config.GeometrySource != nullptr)
+    std::unique_ptr<ShaderProgram> ShaderProgram::TryCreate(const ShaderProgramConfig& Config)
+    {
+        Build SyncBuild = BeginBuild(Config);
+
+        if (!FinishBuild(SyncBuild))
         {
-            GeometryShader = glCreateShader(GL_GEOMETRY_SHADER);
-            glShaderSource(GeometryShader, 1, &Config.GeometrySource, nullptr);
-            glCompileShader(GeometryShader);
-            assert(LogShaderCompilationStatus(GeometryShader));
+            AbandonBuild(SyncBuild);
+            return nullptr;
         }
 
-        Program = glCreateProgram();
+        return std::unique_ptr<ShaderProgram>(new ShaderProgram(SyncBuild));
+    }
 
-        glAttachShader(Program, VertexShader);
-        glAttachShader(Program, FragmentShader);
-        if (GeometryShader != 0) glAttachShader(Program, GeometryShader);
+    std::unique_ptr<ShaderProgram> ShaderProgram::TryCreate(const ShaderArchive& Archive, const std::string& Name, const char* CacheDirectory)
+    {
+        const ShaderArchiveEntry* Entry = Archive.Find(Name);
+        if (!Entry)
+        {
+            Log::Error<LogCategory::Shader>("Shader {} isn't in the archive", Name);
+            return nullptr;
+        }
 
+        return TryCreate(Entry->GetConfig(CacheDirectory));
+    }
 
-        glLinkProgram(Program);
-        assert(LogProgramLinkStatus());
+    ShaderProgram::ShaderProgram(Build& FinishedBuild)
+    {
+        Program = FinishedBuild.Program;
+        Stages = FinishedBuild.Stages;
+        Separable = FinishedBuild.Separable;
+        FinishedBuild.Program = 0;
 
-        glDeleteShader(VertexShader);
-        glDeleteShader(FragmentShader);
-        if (GeometryShader != 0) glDeleteShader(GeometryShader);
+        ReflectUniforms();
     }
 
     ShaderProgram::~ShaderProgram()
     {
-        for (auto& Pair : UniformLocations)
-        {
-            //i know this is unsafe, but i allocated the memory so im deleting it
-            char* String = const_cast<char*>(Pair.first);
-            free(String);
-        }
-        
+        //a deleted program stays current until something else is bound, but its name may be reused
+        //once it isn't so don't let a new program with the same name skip its glUseProgram
+        if (BoundProgram == Program)
+            BoundProgramKnown = false;
+
         glDeleteProgram(Program);
     }
 
     void ShaderProgram::Use()
     {
+        BindProgram(Program);
+    }
+
+    void ShaderProgram::BindProgram(GLuint Program)
+    {
+        if (BoundProgramKnown && BoundProgram == Program)
+            return;
+
         glUseProgram(Program);
+        BoundProgram = Program;
+        BoundProgramKnown = true;
+    }
+
+    GLuint ShaderProgram::BindProgramForUpload(GLuint Program)
+    {
+        if (!BoundProgramKnown)
+        {
+            GLint Current = 0;
+            glGetIntegerv(GL_CURRENT_PROGRAM, &Current);
+
+            BoundProgram = static_cast<GLuint>(Current);
+            BoundProgramKnown = true;
+        }
+
+        GLuint Previous = BoundProgram;
+        BindProgram(Program);
+
+        return Previous;
+    }
+
+    void ShaderProgram::Unbind()
+    {
+        if (BoundProgramKnown && BoundProgram == 0)
+            return;
+
+        glUseProgram(0);
+        BoundProgram = 0;
+        BoundProgramKnown = true;
+    }
+
+    void ShaderProgram::ResetBoundProgram()
+    {
+        BoundProgramKnown = false;
     }
 
     GLuint ShaderProgram::GetInstance() const 
@@ -66,7 +128,683 @@ namespace Base
         return Program;
     }
 
-    bool ShaderProgram::LogShaderCompilationStatus(GLuint Shader)
+    void ShaderProgram::Swap(ShaderProgram& Other)
+    {
+        Generation++;
+
+        //upload stats describe this object's lifetime and stay where they are
+        std::swap(Program, Other.Program);
+        std::swap(UniformTable, Other.UniformTable);
+        std::swap(UniformTableMask, Other.UniformTableMask);
+        std::swap(UniformShadows, Other.UniformShadows);
+        std::swap(UniformShadowData, Other.UniformShadowData);
+        std::swap(UniformShadowValid, Other.UniformShadowValid);
+        std::swap(Reflection, Other.Reflection);
+        std::swap(Stages, Other.Stages);
+        std::swap(Separable, Other.Separable);
+        std::swap(WorkGroupSize, Other.WorkGroupSize);
+    }
+
+    const UniformUploadStats& ShaderProgram::GetUniformUploadStats() const
+    {
+        return UploadStats;
+    }
+
+    void ShaderProgram::ResetUniformUploadStats()
+    {
+        UploadStats = UniformUploadStats{};
+    }
+
+    u32 ShaderProgram::GetGeneration() const
+    {
+        return Generation;
+    }
+
+    const ShaderReflection& ShaderProgram::GetReflection() const
+    {
+        return Reflection;
+    }
+
+    const std::vector<UniformBlockLayout>& ShaderProgram::GetUniformBlocks() const
+    {
+        return Reflection.UniformBlocks;
+    }
+
+    const UniformBlockLayout* ShaderProgram::FindUniformBlock(UniformName Name) const
+    {
+        return Reflection.FindUniformBlock(Name);
+    }
+
+    const std::vector<ShaderStorageBlock>& ShaderProgram::GetStorageBlocks() const
+    {
+        return Reflection.StorageBlocks;
+    }
+
+    const ShaderStorageBlock* ShaderProgram::FindStorageBlock(UniformName Name) const
+    {
+        return Reflection.FindStorageBlock(Name);
+    }
+
+    bool ShaderProgram::BindStorageBlock(UniformName Name, GLuint Binding)
+    {
+        for (ShaderStorageBlock& Block : Reflection.StorageBlocks)
+        {
+            if (Block.NameHash != Name.Hash)
+                continue;
+
+            if (Block.Binding != static_cast<GLint>(Binding))
+            {
+                glShaderStorageBlockBinding(Program, Block.Index, Binding);
+                Block.Binding = static_cast<GLint>(Binding);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ShaderProgram::IsCompute() const
+    {
+        return (Stages & GL_COMPUTE_SHADER_BIT) != 0;
+    }
+
+    bool ShaderProgram::IsSeparable() const
+    {
+        return Separable;
+    }
+
+    GLbitfield ShaderProgram::GetStages() const
+    {
+        return Stages;
+    }
+
+    uvec3 ShaderProgram::GetWorkGroupSize() const
+    {
+        return WorkGroupSize;
+    }
+
+    void ShaderProgram::Dispatch(u32 GroupsX, u32 GroupsY, u32 GroupsZ)
+    {
+        assert(IsCompute());
+
+        Use();
+        glDispatchCompute(GroupsX, GroupsY, GroupsZ);
+    }
+
+    void ShaderProgram::DispatchThreads(const uvec3& Threads)
+    {
+        assert(IsCompute());
+
+        uvec3 Groups = (Threads + WorkGroupSize - 1u) / WorkGroupSize;
+        Dispatch(Groups.x, Groups.y, Groups.z);
+    }
+
+    void ShaderProgram::DispatchIndirect(GLuint Buffer, GLintptr Offset)
+    {
+        assert(IsCompute());
+
+        Use();
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, Buffer);
+        glDispatchComputeIndirect(Offset);
+    }
+
+    bool ShaderProgram::BindUniformBlock(UniformName Name, GLuint Binding)
+    {
+        for (UniformBlockLayout& Block : Reflection.UniformBlocks)
+        {
+            if (Block.NameHash != Name.Hash)
+                continue;
+
+            if (Block.Binding != static_cast<GLint>(Binding))
+            {
+                glUniformBlockBinding(Program, Block.Index, Binding);
+                Block.Binding = static_cast<GLint>(Binding);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    struct ProgramBinaryHeader
+    {
+        static constexpr u32 ExpectedMagic = 0x42504C47; //"GLPB"
+        static constexpr u32 ExpectedVersion = 1;
+
+        u32 Magic;
+        u32 Version;
+        u64 Key;
+        u32 Format;
+        u32 Length;
+    };
+
+    static std::filesystem::path GetProgramCachePath(const char* Directory, u64 Key)
+    {
+        char FileName[32];
+        std::snprintf(FileName, sizeof(FileName), "%016llx.glbin", static_cast<unsigned long long>(Key));
+
+        return std::filesystem::path(Directory) / FileName;
+    }
+
+    bool ShaderProgram::CanUseSpirv(const ShaderProgramConfig& Config)
+    {
+        if (!GetGlExtensions().Spirv)
+            return false;
+
+        const char* Sources[] = { Config.VertexSource, Config.FragmentSource, Config.GeometrySource, Config.ComputeSource };
+        const ShaderSpirvModule* Modules[] = { &Config.VertexSpirv, &Config.FragmentSpirv, &Config.GeometrySpirv, &Config.ComputeSpirv };
+
+        for (std::size_t i = 0; i < std::size(Sources); i++)
+        {
+            if (Sources[i] != nullptr && (Modules[i]->Words == nullptr || Modules[i]->WordCount == 0))
+                return false;
+        }
+
+        return true;
+    }
+
+    u64 ShaderProgram::GetProgramCacheKey(const ShaderProgramConfig& Config)
+    {
+        //binaries are only valid for the driver that produced them, so it is part of the key
+        const char* DriverStrings[] = 
+        {
+            reinterpret_cast<const char*>(glGetString(GL_VENDOR)),
+            reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+            reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+        };
+
+        u64 Key = HashOffsetBasis;
+
+        for (const char* String : DriverStrings)
+            Key = HashBytes("\0", 1, HashString(String ? String : "", Key));
+
+        //a separator after every stage so moving text between stages changes the key
+        const char* Sources[] = { Config.VertexSource, Config.FragmentSource, Config.GeometrySource, Config.ComputeSource };
+
+        for (const char* Source : Sources)
+            Key = HashBytes("\0", 1, HashString(Source ? Source : "", Key));
+
+        //a separable binary can't stand in for a monolithic one or the other way around, and one
+        //specialized from SPIR-V may not know the uniform names the GLSL version does
+        bool Spirv = CanUseSpirv(Config);
+        Key = HashBytes(&Config.Separable, sizeof(Config.Separable), Key);
+        Key = HashBytes(&Spirv, sizeof(Spirv), Key);
+
+        //the modules are what gets built then, so a new module with the same GLSL needs a new binary
+        if (Spirv)
+        {
+            const ShaderSpirvModule* Modules[] = { &Config.VertexSpirv, &Config.FragmentSpirv, &Config.GeometrySpirv, &Config.ComputeSpirv };
+
+            for (const ShaderSpirvModule* Module : Modules)
+            {
+                u64 WordCount = Module->WordCount;
+                Key = HashBytes(&WordCount, sizeof(WordCount), Key);
+
+                if (Module->Words != nullptr)
+                    Key = HashBytes(Module->Words, Module->WordCount * sizeof(u32), Key);
+            }
+        }
+
+        return Key;
+    }
+
+    bool ShaderProgram::LoadProgramBinary(GLuint Program, const char* Directory, u64 Key)
+    {
+        std::ifstream File(GetProgramCachePath(Directory, Key), std::ios::binary);
+        if (!File)
+            return false;
+
+        ProgramBinaryHeader Header;
+        if (!File.read(reinterpret_cast<char*>(&Header), sizeof(Header)))
+            return false;
+
+        if (Header.Magic != ProgramBinaryHeader::ExpectedMagic || Header.Version != ProgramBinaryHeader::ExpectedVersion || Header.Key != Key)
+            return false;
+
+        std::vector<char> Binary;
+        Binary.resize(Header.Length);
+
+        if (!File.read(Binary.data(), Binary.size()))
+            return false;
+
+        glProgramBinary(Program, Header.Format, Binary.data(), static_cast<GLsizei>(Binary.size()));
+
+        //the driver may reject binaries from an older version of itself, we just compile from source then
+        GLint LinkStatus = GL_FALSE;
+        glGetProgramiv(Program, GL_LINK_STATUS, &LinkStatus);
+
+        return LinkStatus == GL_TRUE;
+    }
+
+    void ShaderProgram::SaveProgramBinary(GLuint Program, const char* Directory, u64 Key)
+    {
+        GLint LinkStatus = GL_FALSE;
+        glGetProgramiv(Program, GL_LINK_STATUS, &LinkStatus);
+        if (LinkStatus != GL_TRUE)
+            return;
+
+        GLint Length = 0;
+        glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &Length);
+        if (Length <= 0)
+            return;
+
+        std::vector<char> Binary;
+        Binary.resize(Length);
+
+        GLenum Format = 0;
+        glGetProgramBinary(Program, Length, &Length, &Format, Binary.data());
+
+        ProgramBinaryHeader Header;
+        Header.Magic = ProgramBinaryHeader::ExpectedMagic;
+        Header.Version = ProgramBinaryHeader::ExpectedVersion;
+        Header.Key = Key;
+        Header.Format = Format;
+        Header.Length = static_cast<u32>(Length);
+
+        std::error_code Error;
+        std::filesystem::create_directories(Directory, Error);
+
+        //write to a temporary file first so a crash or a second process never leaves a half written blob
+        std::filesystem::path Path = GetProgramCachePath(Directory, Key);
+        std::filesystem::path TempPath = Path;
+        TempPath += ".tmp";
+
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            if (!File)
+            {
+                Log::Warning<LogCategory::Shader>("Failed to write program binary {}", TempPath.string());
+                return;
+            }
+
+            File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+            File.write(Binary.data(), Header.Length);
+        }
+
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            Log::Warning<LogCategory::Shader>("Failed to write program binary {}: {}", Path.string(), Error.message());
+            std::filesystem::remove(TempPath, Error);
+        }
+    }
+
+    void ShaderProgram::ReflectUniforms()
+    {
+        DirectUniforms = GetGlExtensions().ProgramUniform;
+
+        GLint UniformCount = 0;
+        GLint MaxNameLength = 0;
+        glGetProgramiv(Program, GL_ACTIVE_UNIFORMS, &UniformCount);
+        glGetProgramiv(Program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &MaxNameLength);
+
+        //room for the longest name plus any "[index]" suffix we append for array elements
+        std::vector<char> Name;
+        Name.resize(MaxNameLength + 16);
+
+        std::vector<UniformSlot> Slots;
+        u32 UnnamedCount = 0;
+
+        auto AddUniform = [&](std::size_t NameLength, GLint Location)
+        {
+            if (Location != -1)
+                Slots.push_back({ HashBytes(Name.data(), NameLength), Location });
+        };
+
+        for (GLint i = 0; i < UniformCount; i++)
+        {
+            GLsizei NameLength = 0;
+            GLint ArraySize = 0;
+            GLenum Type = 0;
+            glGetActiveUniform(Program, static_cast<GLuint>(i), MaxNameLength, &NameLength, &ArraySize, &Type, Name.data());
+
+            //SPIR-V doesn't have to keep names, those uniforms are only reachable by their explicit location
+            bool Unnamed = NameLength == 0;
+            GLint Location = -1;
+
+            if (!Unnamed)
+            {
+                Location = glGetUniformLocation(Program, Name.data());
+            }
+            else if (GetGlExtensions().ShaderStorageBuffer)
+            {
+                GLenum Property = GL_LOCATION;
+                glGetProgramResourceiv(Program, GL_UNIFORM, static_cast<GLuint>(i), 1, &Property, 1, nullptr, &Location);
+            }
+
+            //members of uniform blocks have no location and are skipped
+            if (Location == -1)
+                continue;
+
+            ReflectedUniform& Uniform = Reflection.Uniforms.emplace_back();
+            Uniform.Name.assign(Name.data(), NameLength);
+            Uniform.Type = Type;
+            Uniform.ArraySize = ArraySize;
+            Uniform.Location = Location;
+
+            if (IsSamplerType(Type) || IsImageType(Type))
+            {
+                ReflectedSampler& Sampler = Reflection.Samplers.emplace_back();
+                Sampler.Type = Type;
+                Sampler.ArraySize = ArraySize;
+                Sampler.Location = Location;
+                glGetUniformiv(Program, Location, &Sampler.Unit);
+            }
+
+            //shadow storage for the whole array, every element starts out unknown
+            u32 ElementSize = GetUniformTypeSize(Type);
+            u32 DataOffset = static_cast<u32>(UniformShadowData.size());
+            u32 FirstElement = static_cast<u32>(UniformShadowValid.size());
+
+            UniformShadowData.resize(UniformShadowData.size() + ElementSize * ArraySize);
+            UniformShadowValid.resize(UniformShadowValid.size() + ArraySize, 0);
+
+            AddUniformShadow(Location, Type, DataOffset, FirstElement, ElementSize, ArraySize);
+
+            //the elements of an array with an explicit location take the locations after it
+            if (Unnamed)
+            {
+                UnnamedCount++;
+
+                for (GLint Element = 1; Element < ArraySize; Element++)
+                    AddUniformShadow(Location + Element, Type, DataOffset + Element * ElementSize, FirstElement + Element, ElementSize, ArraySize - Element);
+
+                continue;
+            }
+
+            //arrays are reported as "Name[0]", register "Name" and every "Name[i]" as well
+            constexpr char ArraySuffix[] = "[0]";
+            constexpr std::size_t ArraySuffixLength = sizeof(ArraySuffix) - 1;
+
+            bool IsArray = static_cast<std::size_t>(NameLength) > ArraySuffixLength && std::strcmp(&Name[NameLength - ArraySuffixLength], ArraySuffix) == 0;
+            std::size_t BaseLength = IsArray ? NameLength - ArraySuffixLength : NameLength;
+
+            Uniform.Name.resize(BaseLength);
+            Uniform.NameHash = HashString(Uniform.Name.c_str());
+
+            if (!Reflection.Samplers.empty() && Reflection.Samplers.back().Location == Location)
+            {
+                Reflection.Samplers.back().Name = Uniform.Name;
+                Reflection.Samplers.back().NameHash = Uniform.NameHash;
+            }
+
+            AddUniform(BaseLength, Location);
+
+            if (!IsArray)
+                continue;
+
+            for (GLint Element = 0; Element < ArraySize; Element++)
+            {
+                int SuffixLength = std::snprintf(&Name[BaseLength], Name.size() - BaseLength, "[%d]", Element);
+                GLint ElementLocation = glGetUniformLocation(Program, Name.data());
+
+                AddUniform(BaseLength + SuffixLength, ElementLocation);
+                AddUniformShadow(ElementLocation, Type, DataOffset + Element * ElementSize, FirstElement + Element, ElementSize, ArraySize - Element);
+            }
+        }
+
+        if (UnnamedCount != 0)
+            Log::Warning<LogCategory::Shader>("Program {} has {} uniforms without names, SetUniform by name can't find them, set them by location", Program, UnnamedCount);
+
+        //keep the load factor at or below one half so probe sequences stay short
+        std::size_t Capacity = 1;
+        while (Capacity < Slots.size() * 2)
+            Capacity <<= 1;
+
+        UniformTable.assign(Capacity, UniformSlot{});
+        UniformTableMask = Capacity - 1;
+
+        for (std::size_t i = 0; i < Slots.size(); i++)
+        {
+            u64 Index = Slots[i].NameHash & UniformTableMask;
+
+            while (UniformTable[Index].Location != -1)
+            {
+                //lookups only compare hashes, so two names sharing one would silently alias
+                assert(UniformTable[Index].NameHash != Slots[i].NameHash && "Uniform name hash collision");
+                Index = (Index + 1) & UniformTableMask;
+            }
+
+            UniformTable[Index] = Slots[i];
+        }
+
+        Reflection.UniformBlocks = ReflectUniformBlocks(Program);
+        Reflection.Attributes = ReflectAttributes(Program);
+
+        if (GetGlExtensions().ShaderStorageBuffer)
+            Reflection.StorageBlocks = ReflectStorageBlocks(Program);
+
+        //only compute programs have a work group size, asking anything else is an error
+        if (IsCompute())
+        {
+            GLint Size[3] = {};
+            glGetProgramiv(Program, GL_COMPUTE_WORK_GROUP_SIZE, Size);
+
+            WorkGroupSize = uvec3(Size[0], Size[1], Size[2]);
+        }
+    }
+
+    void ShaderProgram::AddUniformShadow(GLint Location, GLenum Type, u32 DataOffset, u32 FirstElement, u32 ElementSize, u32 ElementCount)
+    {
+        if (Location == -1)
+            return;
+
+        if (static_cast<std::size_t>(Location) >= UniformShadows.size())
+            UniformShadows.resize(Location + 1);
+
+        UniformShadows[Location] = UniformShadow{ DataOffset, FirstElement, ElementSize, ElementCount, Type, GetUploadThunk(Type, DirectUniforms) };
+    }
+
+    bool ShaderProgram::SetUniformData(UniformName Name, const void* Data, GLsizei Count)
+    {
+        GLint Location = GetUniformLocation(Name);
+        if (Location == -1)
+            return false;
+
+        const UniformShadow& Shadow = UniformShadows[Location];
+
+        if (Shadow.Upload == nullptr || Count < 0 || static_cast<u32>(Count) > Shadow.ElementCount)
+        {
+            ReportUniformMismatch(Location, 0, Count);
+            return false;
+        }
+
+        UploadUniformData(Location, Data, Count);
+
+        return true;
+    }
+
+    template<typename T, bool Direct>
+    void ShaderProgram::UploadThunk(GLuint Program, GLint Location, GLsizei Count, const void* Values)
+    {
+        if constexpr (Direct)
+        {
+            UploadProgramUniform(Program, Location, static_cast<const T*>(Values), Count);
+        }
+        else
+        {
+            GLuint Previous = BindProgramForUpload(Program);
+            UploadCurrentUniform(Location, static_cast<const T*>(Values), Count);
+            BindProgram(Previous);
+        }
+    }
+
+    template<bool Direct>
+    ShaderProgram::UniformUploadThunk ShaderProgram::SelectUploadThunk(GLenum Type)
+    {
+        switch (Type)
+        {
+            case(GL_INT): case(GL_BOOL): return &UploadThunk<i32, Direct>;
+            case(GL_INT_VEC2): case(GL_BOOL_VEC2): return &UploadThunk<ivec2, Direct>;
+            case(GL_INT_VEC3): case(GL_BOOL_VEC3): return &UploadThunk<ivec3, Direct>;
+            case(GL_INT_VEC4): case(GL_BOOL_VEC4): return &UploadThunk<ivec4, Direct>;
+            case(GL_UNSIGNED_INT): return &UploadThunk<u32, Direct>;
+            case(GL_UNSIGNED_INT_VEC2): return &UploadThunk<uvec2, Direct>;
+            case(GL_UNSIGNED_INT_VEC3): return &UploadThunk<uvec3, Direct>;
+            case(GL_UNSIGNED_INT_VEC4): return &UploadThunk<uvec4, Direct>;
+            case(GL_FLOAT): return &UploadThunk<f32, Direct>;
+            case(GL_FLOAT_VEC2): return &UploadThunk<vec2, Direct>;
+            case(GL_FLOAT_VEC3): return &UploadThunk<vec3, Direct>;
+            case(GL_FLOAT_VEC4): return &UploadThunk<vec4, Direct>;
+            case(GL_FLOAT_MAT2): return &UploadThunk<mat2x2, Direct>;
+            case(GL_FLOAT_MAT3): return &UploadThunk<mat3x3, Direct>;
+            case(GL_FLOAT_MAT4): return &UploadThunk<mat4x4, Direct>;
+            case(GL_FLOAT_MAT2x3): return &UploadThunk<mat2x3, Direct>;
+            case(GL_FLOAT_MAT3x2): return &UploadThunk<mat3x2, Direct>;
+            case(GL_FLOAT_MAT2x4): return &UploadThunk<mat2x4, Direct>;
+            case(GL_FLOAT_MAT4x2): return &UploadThunk<mat4x2, Direct>;
+            case(GL_FLOAT_MAT3x4): return &UploadThunk<mat3x4, Direct>;
+            case(GL_FLOAT_MAT4x3): return &UploadThunk<mat4x3, Direct>;
+        }
+
+        if (IsSamplerType(Type) || IsImageType(Type))
+            return &UploadThunk<i32, Direct>;
+
+        return nullptr;
+    }
+
+    ShaderProgram::UniformUploadThunk ShaderProgram::GetUploadThunk(GLenum Type, bool Direct)
+    {
+        return Direct ? SelectUploadThunk<true>(Type) : SelectUploadThunk<false>(Type);
+    }
+
+    void ShaderProgram::ReportUniformMismatch(GLint Location, GLenum Type, GLsizei Count) const
+    {
+        const UniformShadow& Shadow = UniformShadows[Location];
+
+        //array elements have their own locations, find the array they belong to for the name
+        const ReflectedUniform* Uniform = nullptr;
+        for (const ReflectedUniform& Candidate : Reflection.Uniforms)
+        {
+            if (Candidate.Location <= Location && Location < Candidate.Location + Candidate.ArraySize)
+                Uniform = &Candidate;
+        }
+
+        std::string Message = "Uniform " + (Uniform ? Uniform->Name : "at location " + std::to_string(Location)) + " is a " + GetUniformTypeName(Shadow.Type);
+        if (Shadow.ElementCount > 1)
+            Message += "[" + std::to_string(Shadow.ElementCount) + "]";
+
+        if (Type != 0)
+            Message += std::string(", written as ") + GetUniformTypeName(Type);
+
+        Log::Error<LogCategory::Shader>("{} with a count of {}", Message, Count);
+
+        assert(false && "SetUniform doesn't match the reflected uniform");
+    }
+
+    ShaderProgram::Build ShaderProgram::BeginBuild(const ShaderProgramConfig& Config)
+    {
+        //either a graphics program or a compute program, never both, separable programs may hold any subset
+        bool Graphics = Config.VertexSource || Config.FragmentSource || Config.GeometrySource;
+        assert(Config.ComputeSource ? !Graphics : Graphics);
+        assert(Config.Separable || Config.ComputeSource || (Config.VertexSource && Config.FragmentSource));
+        assert(!Config.ComputeSource || GetGlExtensions().ComputeShader);
+        assert(!Config.Separable || GetGlExtensions().SeparateShaderObjects);
+
+        const char* Sources[] = { Config.VertexSource, Config.FragmentSource, Config.GeometrySource, Config.ComputeSource };
+        const GLenum Stages[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER, GL_COMPUTE_SHADER };
+        const GLbitfield StageBits[] = { GL_VERTEX_SHADER_BIT, GL_FRAGMENT_SHADER_BIT, GL_GEOMETRY_SHADER_BIT, GL_COMPUTE_SHADER_BIT };
+        const ShaderSpirvModule* Modules[] = { &Config.VertexSpirv, &Config.FragmentSpirv, &Config.GeometrySpirv, &Config.ComputeSpirv };
+        bool UseSpirv = CanUseSpirv(Config);
+
+        Build NewBuild;
+        NewBuild.Program = glCreateProgram();
+        NewBuild.Separable = Config.Separable;
+        NewBuild.UseBinaryCache = Config.CacheDirectory != nullptr && GetGlExtensions().ProgramBinary;
+
+        for (std::size_t i = 0; i < std::size(Sources); i++)
+        {
+            if (Sources[i] != nullptr)
+                NewBuild.Stages |= StageBits[i];
+        }
+
+        if (NewBuild.UseBinaryCache)
+        {
+            NewBuild.CacheDirectory = Config.CacheDirectory;
+            NewBuild.CacheKey = GetProgramCacheKey(Config);
+
+            if (LoadProgramBinary(NewBuild.Program, Config.CacheDirectory, NewBuild.CacheKey))
+            {
+                NewBuild.LoadedFromCache = true;
+                return NewBuild;
+            }
+        }
+
+        //compiling and linking is only submitted here, nothing asks for a status until FinishBuild
+        //so drivers that compile on background threads never have to stall
+        for (std::size_t i = 0; i < std::size(Sources); i++)
+        {
+            if (Sources[i] == nullptr)
+                continue;
+
+            GLuint Shader = glCreateShader(Stages[i]);
+
+            //specializing sets the compile status just like compiling does, FinishBuild can't tell them apart
+            if (UseSpirv)
+            {
+                GLsizei Length = static_cast<GLsizei>(Modules[i]->WordCount * sizeof(u32));
+                glShaderBinary(1, &Shader, GL_SHADER_BINARY_FORMAT_SPIR_V, Modules[i]->Words, Length);
+                glSpecializeShader(Shader, "main", 0, nullptr, nullptr);
+            }
+            else
+            {
+                glShaderSource(Shader, 1, &Sources[i], nullptr);
+                glCompileShader(Shader);
+            }
+
+            glAttachShader(NewBuild.Program, Shader);
+
+            NewBuild.Shaders[i] = Shader;
+        }
+
+        if (NewBuild.UseBinaryCache) glProgramParameteri(NewBuild.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        if (NewBuild.Separable) glProgramParameteri(NewBuild.Program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+
+        glLinkProgram(NewBuild.Program);
+
+        return NewBuild;
+    }
+
+    bool ShaderProgram::FinishBuild(Build& PendingBuild)
+    {
+        if (PendingBuild.LoadedFromCache)
+            return true;
+
+        bool Success = true;
+
+        for (GLuint& Shader : PendingBuild.Shaders)
+        {
+            if (Shader == 0)
+                continue;
+
+            Success &= LogShaderCompilationStatus(Shader, PendingBuild.InfoLog);
+
+            glDeleteShader(Shader);
+            Shader = 0;
+        }
+
+        Success &= LogProgramLinkStatus(PendingBuild.Program, PendingBuild.InfoLog);
+
+        if (Success && PendingBuild.UseBinaryCache) SaveProgramBinary(PendingBuild.Program, PendingBuild.CacheDirectory.c_str(), PendingBuild.CacheKey);
+
+        return Success;
+    }
+
+    void ShaderProgram::AbandonBuild(Build& PendingBuild)
+    {
+        for (GLuint& Shader : PendingBuild.Shaders)
+        {
+            if (Shader != 0) glDeleteShader(Shader);
+            Shader = 0;
+        }
+
+        if (PendingBuild.Program != 0) glDeleteProgram(PendingBuild.Program);
+        PendingBuild.Program = 0;
+    }
+
+    bool ShaderProgram::LogShaderCompilationStatus(GLuint Shader, std::string& InfoLog)
     {
         GLint CompileStatus;
         glGetShaderiv(Shader, GL_COMPILE_STATUS, &CompileStatus);
@@ -77,19 +815,20 @@ namespace Base
 
             glGetShaderiv(Shader, GL_INFO_LOG_LENGTH, &LogLength);
 
-            std::vector<char> InfoLog;
-            InfoLog.resize(LogLength + 1);
+            std::vector<char> LogText;
+            LogText.resize(LogLength + 1);
 
-            glGetShaderInfoLog(Shader, static_cast<GLsizei>(InfoLog.size()), nullptr, InfoLog.data());
+            glGetShaderInfoLog(Shader, static_cast<GLsizei>(LogText.size()), nullptr, LogText.data());
 
-            std::cerr << InfoLog.data() << "\n";
+            Log::Warning<LogCategory::Shader>("Shader failed to compile:\n{}", LogText.data());
+            InfoLog += LogText.data();
             return false;
         }
 
         return true;
     }
 
-    bool ShaderProgram::LogProgramLinkStatus()
+    bool ShaderProgram::LogProgramLinkStatus(GLuint Program, std::string& InfoLog)
     {
         GLint LinkStatus;
         glGetProgramiv(Program, GL_LINK_STATUS, &LinkStatus);
@@ -99,12 +838,13 @@ namespace Base
             GLint LogLength;
             glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &LogLength);
             
-            std::vector<char> InfoLog;
-            InfoLog.resize(LogLength + 1);
+            std::vector<char> LogText;
+            LogText.resize(LogLength + 1);
 
-            glGetProgramInfoLog(Program, static_cast<GLsizei>(InfoLog.size()), nullptr, InfoLog.data());
+            glGetProgramInfoLog(Program, static_cast<GLsizei>(LogText.size()), nullptr, LogText.data());
 
-            std::cerr << InfoLog.data() << "\n";
+            Log::Warning<LogCategory::Shader>("Program failed to link:\n{}", LogText.data());
+            InfoLog += LogText.data();
             return false;
         }
 
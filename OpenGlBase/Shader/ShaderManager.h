@@ -2,18 +2,61 @@
 #include <glad/glad.h>
 #include <type_traits>
 #include <vector>
-#include <unordered_map>
-#include <functional>
+#include <string>
+#include <memory>
+#include <cstring>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "UniformName.h"
+#include "UniformBlock.h"
+#include "ShaderReflection.h"
+#include "../Gl/GlExtensions.h"
+
 namespace Base
 {
+    class ShaderArchive;
+
+    //one SPIR-V module, the words are copied by the driver so they only have to outlive the build call
+    struct ShaderSpirvModule
+    {
+        const u32* Words = nullptr;
+        std::size_t WordCount = 0;
+    };
+
     struct ShaderProgramConfig
     {
         const char* VertexSource;
         const char* FragmentSource;
         const char* GeometrySource;
+
+        //when set, linked programs are stored here with glGetProgramBinary and loaded back
+        //with glProgramBinary on later runs instead of compiling from source
+        const char* CacheDirectory = nullptr;
+
+        //a compute program sets only this and leaves the vertex and fragment sources null,
+        //needs GetGlExtensions().ComputeShader
+        const char* ComputeSource = nullptr;
+
+        //links with GL_PROGRAM_SEPARABLE so the program can be combined with others in a ShaderPipeline,
+        //a separable program may contain any subset of the stages
+        bool Separable = false;
+
+        //SPIR-V for the stages that have a source, with main as the entry point. when every stage has
+        //a module and GetGlExtensions().Spirv is set they are specialized instead of compiling the sources,
+        //which are still needed for drivers without it. SPIR-V doesn't have to keep uniform names so
+        //uniforms should have explicit locations, set with the SetUniform taking one, and blocks explicit
+        //bindings
+        ShaderSpirvModule VertexSpirv;
+        ShaderSpirvModule FragmentSpirv;
+        ShaderSpirvModule GeometrySpirv;
+        ShaderSpirvModule ComputeSpirv;
+    };
+
+    struct UniformUploadStats
+    {
+        u64 Issued = 0;
+        u64 Skipped = 0;
     };
     
     class ShaderProgram
@@ -26,11 +69,66 @@ namespace Base
         ShaderProgram(const ShaderProgramConfig& Config);
         ~ShaderProgram();
 
+        //unlike the constructor this doesn't assert on compile or link errors, it returns null instead
+        static std::unique_ptr<ShaderProgram> TryCreate(const ShaderProgramConfig& Config);
+
+        //builds a program cooked into an archive by ShaderCook, null if it isn't in there or fails to build
+        static std::unique_ptr<ShaderProgram> TryCreate(const ShaderArchive& Archive, const std::string& Name, const char* CacheDirectory = nullptr);
+
+        //skips the glUseProgram when this program is already current, anything that changes the current
+        //program behind our back has to call ResetBoundProgram
         void Use();
         GLuint GetInstance() const;
 
+        //makes no program current so a bound ShaderPipeline takes effect
+        static void Unbind();
+
+        //forgets which program is current, for code that calls glUseProgram itself
+        static void ResetBoundProgram();
+
+        const UniformUploadStats& GetUniformUploadStats() const;
+        void ResetUniformUploadStats();
+
+        //every active uniform, sampler, attribute, uniform block and storage block with their types and layouts
+        const ShaderReflection& GetReflection() const;
+
+        //goes up every time a hot reload swaps a rebuilt program in, locations looked up before that
+        //may have moved
+        u32 GetGeneration() const;
+
+        const std::vector<UniformBlockLayout>& GetUniformBlocks() const;
+        const UniformBlockLayout* FindUniformBlock(UniformName Name) const;
+
+        //points the named block at a binding index, bind a UniformRingBuffer allocation to the same index
+        bool BindUniformBlock(UniformName Name, GLuint Binding);
+
+        //empty without GetGlExtensions().ShaderStorageBuffer
+        const std::vector<ShaderStorageBlock>& GetStorageBlocks() const;
+        const ShaderStorageBlock* FindStorageBlock(UniformName Name) const;
+        bool BindStorageBlock(UniformName Name, GLuint Binding);
+
+        bool IsCompute() const;
+        bool IsSeparable() const;
+
+        //GL_*_SHADER_BIT for every stage the program was built from
+        GLbitfield GetStages() const;
+
+        //the local_size declared in the compute shader, zero for other programs
+        uvec3 GetWorkGroupSize() const;
+
+        //all three make this the current program first
+        void Dispatch(u32 GroupsX, u32 GroupsY = 1, u32 GroupsZ = 1);
+
+        //enough groups to cover Threads invocations, rounding up to whole work groups
+        void DispatchThreads(const uvec3& Threads);
+
+        //reads the group counts as three GLuints at Offset in Buffer
+        void DispatchIndirect(GLuint Buffer, GLintptr Offset = 0);
+
+        //neither needs the program to be current nor changes which one is, see UploadUniform. debug builds
+        //check T against the reflected type and assert on a mismatch instead of leaving it to a GL error
         template<typename T>
-        bool SetUniform(const char* Name, const T& Value)
+        bool SetUniform(UniformName Name, const T& Value)
         {
             GLint Location = GetUniformLocation(Name);
             if (Location == -1)
@@ -42,7 +140,7 @@ namespace Base
         }
 
         template<typename T>
-        bool SetUniform(const char* Name, const T* Values, const GLsizei Count)
+        bool SetUniform(UniformName Name, const T* Values, const GLsizei Count)
         {
             GLint Location = GetUniformLocation(Name);
             if (Location == -1)
@@ -53,118 +151,329 @@ namespace Base
             return true;
         }
 
-    private:
-        using HashFunction = std::function<size_t(const char*)>;
-        using EqualFunction = std::function<bool(const char*, const char*)>;
+        //by location, for uniforms declared with layout(location = N). a program specialized from SPIR-V
+        //may have no uniform names at all and can only be written this way
+        template<typename T>
+        bool SetUniform(GLint Location, const T& Value)
+        {
+            if (Location < 0)
+                return false;
+
+            CheckUniformType<T>(Location, 1);
+
+            if (IsUniformUnchanged(Location, &Value, 1))
+            {
+                UploadStats.Skipped++;
+                return true;
+            }
+
+            UploadStats.Issued++;
+            UploadUniform(Location, Value);
 
+            return true;
+        }
 
-        HashFunction Hash = [](const char* String) -> size_t
+        template<typename T>
+        bool SetUniform(GLint Location, const T* Values, const GLsizei Count)
         {
-            size_t hash = 0;
-            while(*String)
+            if (Location < 0)
+                return false;
+
+            CheckUniformType<T>(Location, Count);
+
+            if (IsUniformUnchanged(Location, Values, Count))
             {
-                hash = hash * 31 + *String++;
+                UploadStats.Skipped++;
+                return true;
             }
-            return hash;
+
+            UploadStats.Issued++;
+            UploadUniform(Location, Values, Count);
+
+            return true;
+        }
+
+        //Count elements laid out the way glUniform* takes them for the reflected type, for callers that only
+        //know the uniform from reflection. goes through the upload thunk picked for the type at link time
+        bool SetUniformData(UniformName Name, const void* Data, GLsizei Count = 1);
+
+    private:
+        friend class ShaderCompileQueue;
+        friend class PendingShaderProgram;
+        friend class ShaderLibrary;
+        friend class ShaderParameterBinding;
+
+        //a program whose stages and link have been submitted but whose status hasn't been checked yet
+        struct Build
+        {
+            GLuint Program = 0;
+            GLuint Shaders[4] = {};
+            GLbitfield Stages = 0;
+            bool Separable = false;
+            bool UseBinaryCache = false;
+            bool LoadedFromCache = false;
+            u64 CacheKey = 0;
+            std::string CacheDirectory;
+
+            //compile and link logs of whatever failed, filled in by FinishBuild
+            std::string InfoLog;
         };
 
-        EqualFunction Equal = [](const char* a, const char* b) -> bool
+        //takes ownership of a build FinishBuild succeeded on
+        ShaderProgram(Build& FinishedBuild);
+
+        static Build BeginBuild(const ShaderProgramConfig& Config);
+        static bool FinishBuild(Build& PendingBuild);
+        static void AbandonBuild(Build& PendingBuild);
+
+        struct UniformSlot
         {
-            return std::strcmp(a, b) == 0;
+            u64 NameHash = 0;
+            GLint Location = -1;
         };
-        
+
+        using UniformUploadThunk = void(*)(GLuint Program, GLint Location, GLsizei Count, const void* Values);
+
+        //last value written to each location, array elements each get their own location entry
+        //pointing into the storage of the whole array so partial array writes are shadowed too
+        //
+        //also holds the reflected type and the upload function matching it, so untyped writes don't
+        //have to switch on the type every time
+        struct UniformShadow
+        {
+            u32 DataOffset = 0;
+            u32 FirstElement = 0;
+            u32 ElementSize = 0;
+            u32 ElementCount = 0;
+            GLenum Type = 0;
+            UniformUploadThunk Upload = nullptr;
+        };
+
         GLuint Program;
-        std::unordered_map<const char*, GLint, HashFunction, EqualFunction> UniformLocations{ 0, Hash, Equal };
 
-        GLint GetUniformLocation(const char* UniformName)
+        //flat open addressing table keyed by the precomputed name hash, built once after linking
+        //from GL_ACTIVE_UNIFORMS and never modified afterwards, empty slots have Location == -1
+        std::vector<UniformSlot> UniformTable;
+        u64 UniformTableMask = 0;
+
+        std::vector<UniformShadow> UniformShadows;
+        std::vector<u8> UniformShadowData;
+        std::vector<u8> UniformShadowValid;
+        UniformUploadStats UploadStats;
+        u32 Generation = 0;
+
+        ShaderReflection Reflection;
+        GLbitfield Stages = 0;
+        bool Separable = false;
+        bool DirectUniforms = false;
+        uvec3 WorkGroupSize = { 0, 0, 0 };
+
+        static bool CanUseSpirv(const ShaderProgramConfig& Config);
+        static u64 GetProgramCacheKey(const ShaderProgramConfig& Config);
+        static bool LoadProgramBinary(GLuint Program, const char* Directory, u64 Key);
+        static void SaveProgramBinary(GLuint Program, const char* Directory, u64 Key);
+
+        void ReflectUniforms();
+        void AddUniformShadow(GLint Location, GLenum Type, u32 DataOffset, u32 FirstElement, u32 ElementSize, u32 ElementCount);
+
+        //makes Program current unless it already is, the tracked glUseProgram behind Use
+        static void BindProgram(GLuint Program);
+
+        //binds Program for a glUniform call and returns what was current before so it can be put back
+        static GLuint BindProgramForUpload(GLuint Program);
+
+        //null for types SetUniform can't write, like doubles
+        static UniformUploadThunk GetUploadThunk(GLenum Type, bool Direct);
+
+        template<bool Direct>
+        static UniformUploadThunk SelectUploadThunk(GLenum Type);
+
+        template<typename T, bool Direct>
+        static void UploadThunk(GLuint Program, GLint Location, GLsizei Count, const void* Values);
+
+        //prints the uniform and both types, then asserts
+        void ReportUniformMismatch(GLint Location, GLenum Type, GLsizei Count) const;
+
+        //a debug build check that T may be written to Location, compiled out in release
+        template<typename T>
+        void CheckUniformType(GLint Location, GLsizei Count) const
         {
-            assert(UniformName);
-            
-            auto Iterator = UniformLocations.find(UniformName);
-            if (Iterator != UniformLocations.end())
+#ifndef NDEBUG
+            if (Location < 0 || static_cast<std::size_t>(Location) >= UniformShadows.size())
+                return;
+
+            const UniformShadow& Shadow = UniformShadows[Location];
+
+            if (!IsUniformTypeCompatible<T>(Shadow.Type) || Count < 0 || static_cast<u32>(Count) > Shadow.ElementCount)
+                ReportUniformMismatch(Location, GetUniformGlType<T>(), Count);
+#endif
+        }
+
+        GLint GetUniformLocation(UniformName Name) const
+        {
+            u64 Index = Name.Hash & UniformTableMask;
+
+            while (true)
             {
-                return Iterator->second;
-            }
-            else
-            {                
-                GLint Location = glGetUniformLocation(Program, UniformName);
-                
-                std::size_t UniformNameLength = strlen(UniformName) + 1;
-                void* Buffer = malloc(UniformNameLength);
-
-                if (Buffer == nullptr)
+                const UniformSlot& Slot = UniformTable[Index];
+
+                if (Slot.Location == -1)
                     return -1;
 
-                memcpy(Buffer, UniformName, UniformNameLength);
-                
-                UniformLocations.emplace(static_cast<const char*>(Buffer), Location);
+                if (Slot.NameHash == Name.Hash)
+                    return Slot.Location;
+
+                Index = (Index + 1) & UniformTableMask;
+            }
+        }
+
+        //returns true when Values matches what was last written to Location, otherwise stores it as the new
+        //shadow value. the written type is checked against the reflected one and not just its size, an i32
+        //written to a float uniform is the same four bytes but must never be shadowed
+        template<typename T>
+        bool IsUniformUnchanged(GLint Location, const T* Values, GLsizei Count)
+        {
+            if (Location < 0 || static_cast<std::size_t>(Location) >= UniformShadows.size())
+                return false;
+
+            if (!IsUniformTypeCompatible<T>(UniformShadows[Location].Type))
+                return false;
+
+            return IsUniformDataUnchanged(Location, Values, sizeof(T), Count);
+        }
+
+        //the untyped part, Data is taken to already be of the shadow's type
+        bool IsUniformDataUnchanged(GLint Location, const void* Data, std::size_t ElementSize, GLsizei Count)
+        {
+            if (Location < 0 || static_cast<std::size_t>(Location) >= UniformShadows.size())
+                return false;
+
+            const UniformShadow& Shadow = UniformShadows[Location];
+
+            //unknown location or a size that doesn't match the reflected type, let the driver deal with it
+            if (Shadow.ElementSize != ElementSize || Count < 0 || static_cast<u32>(Count) > Shadow.ElementCount)
+                return false;
+
+            u8* ShadowData = &UniformShadowData[Shadow.DataOffset];
+            u8* Valid = &UniformShadowValid[Shadow.FirstElement];
+            std::size_t Size = ElementSize * Count;
+
+            bool AllValid = std::memchr(Valid, 0, Count) == nullptr;
+            if (AllValid && std::memcmp(ShadowData, Data, Size) == 0)
+                return true;
+
+            std::memcpy(ShadowData, Data, Size);
+            std::memset(Valid, 1, Count);
 
-                return Location;
+            return false;
+        }
+
+        //the untyped write behind SetUniformData and ShaderParameterBlock, Count has to fit the uniform
+        //and the location must have an upload thunk
+        void UploadUniformData(GLint Location, const void* Data, GLsizei Count)
+        {
+            const UniformShadow& Shadow = UniformShadows[Location];
+
+            if (IsUniformDataUnchanged(Location, Data, Shadow.ElementSize, Count))
+            {
+                UploadStats.Skipped++;
+                return;
             }
+
+            UploadStats.Issued++;
+            Shadow.Upload(Program, Location, Count, Data);
         }
 
         template<typename T>
-        void SetUniform(GLint Location, const T& Value)
-        {
-            if      constexpr (std::is_same_v<T, i32>)   glUniform1i(Location, Value);
-            else if constexpr (std::is_same_v<T, ivec2>) glUniform2i(Location, Value.x, Value.y);
-            else if constexpr (std::is_same_v<T, ivec3>) glUniform3i(Location, Value.x, Value.y, Value.z);
-            else if constexpr (std::is_same_v<T, ivec4>) glUniform4i(Location, Value.x, Value.y, Value.z, Value.w);
-
-            else if constexpr (std::is_same_v<T, u32>)   glUniform1ui(Location, Value);
-            else if constexpr (std::is_same_v<T, uvec2>) glUniform2ui(Location, Value.x, Value.y);
-            else if constexpr (std::is_same_v<T, uvec3>) glUniform3ui(Location, Value.x, Value.y, Value.z);
-            else if constexpr (std::is_same_v<T, uvec4>) glUniform4ui(Location, Value.x, Value.y, Value.z, Value.w);
-
-            else if constexpr (std::is_same_v<T, f32>)   glUniform1f(Location, Value);
-            else if constexpr (std::is_same_v<T, vec2>) glUniform2f(Location, Value.x, Value.y);
-            else if constexpr (std::is_same_v<T, vec3>) glUniform3f(Location, Value.x, Value.y, Value.z);
-            else if constexpr (std::is_same_v<T, vec4>) glUniform4f(Location, Value.x, Value.y, Value.z, Value.w);
-
-            else if constexpr (std::is_same_v<T, mat2x2>)   glUniformMatrix2fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat3x3>)   glUniformMatrix3fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat4x4>)   glUniformMatrix4fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat2x3>) glUniformMatrix2x3fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat3x2>) glUniformMatrix3x2fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat2x4>) glUniformMatrix2x4fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat4x2>) glUniformMatrix4x2fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat3x4>) glUniformMatrix3x4fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
-            else if constexpr (std::is_same_v<T, mat4x3>) glUniformMatrix4x3fv(Location, 1, GL_FALSE, glm::value_ptr(Value));
+        void UploadUniform(GLint Location, const T& Value)
+        {
+            UploadUniform(Location, &Value, 1);
+        }
+
+        //writes straight to the program with glProgramUniform where the driver has it, otherwise the
+        //program is made current for the upload and whatever was current before is bound again, both
+        //binds are skipped when this program already is
+        template <typename T>
+        void UploadUniform(GLint Location, const T* Values, const GLsizei Count)
+        {
+            if (DirectUniforms)
+            {
+                UploadProgramUniform(Program, Location, Values, Count);
+                return;
+            }
+
+            GLuint Previous = BindProgramForUpload(Program);
+            UploadCurrentUniform(Location, Values, Count);
+            BindProgram(Previous);
+        }
+
+        template <typename T>
+        static void UploadProgramUniform(GLuint Program, GLint Location, const T* Values, const GLsizei Count)
+        {
+            if      constexpr (std::is_same_v<T, i32>)   glProgramUniform1iv(Program, Location, Count, Values);
+            else if constexpr (std::is_same_v<T, ivec2>) glProgramUniform2iv(Program, Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, ivec3>) glProgramUniform3iv(Program, Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, ivec4>) glProgramUniform4iv(Program, Location, Count, glm::value_ptr(*Values));
+
+            else if constexpr (std::is_same_v<T, u32>)   glProgramUniform1uiv(Program, Location, Count, Values);
+            else if constexpr (std::is_same_v<T, uvec2>) glProgramUniform2uiv(Program, Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, uvec3>) glProgramUniform3uiv(Program, Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, uvec4>) glProgramUniform4uiv(Program, Location, Count, glm::value_ptr(*Values));
+
+            else if constexpr (std::is_same_v<T, f32>)   glProgramUniform1fv(Program, Location, Count, Values);
+            else if constexpr (std::is_same_v<T, vec2>) glProgramUniform2fv(Program, Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, vec3>) glProgramUniform3fv(Program, Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, vec4>) glProgramUniform4fv(Program, Location, Count, glm::value_ptr(*Values));
+
+            else if constexpr (std::is_same_v<T, mat2x2>)   glProgramUniformMatrix2fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat3x3>)   glProgramUniformMatrix3fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat4x4>)   glProgramUniformMatrix4fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat2x3>) glProgramUniformMatrix2x3fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat3x2>) glProgramUniformMatrix3x2fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat2x4>) glProgramUniformMatrix2x4fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat4x2>) glProgramUniformMatrix4x2fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat3x4>) glProgramUniformMatrix3x4fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat4x3>) glProgramUniformMatrix4x3fv(Program, Location, Count, GL_FALSE, glm::value_ptr(*Values));
             else static_assert(sizeof(T) == 0, "Unsupported uniform type");
         }
 
         template <typename T>
-        void SetUniform(GLint Location, const T* Values, const GLsizei Count)
+        static void UploadCurrentUniform(GLint Location, const T* Values, const GLsizei Count)
         {
             if      constexpr (std::is_same_v<T, i32>)   glUniform1iv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, ivec2>) glUniform2iv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, ivec3>) glUniform3iv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, ivec4>) glUniform4iv(Location, Count, Values);
+            else if constexpr (std::is_same_v<T, ivec2>) glUniform2iv(Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, ivec3>) glUniform3iv(Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, ivec4>) glUniform4iv(Location, Count, glm::value_ptr(*Values));
 
             else if constexpr (std::is_same_v<T, u32>)   glUniform1uiv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, uvec2>) glUniform2uiv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, uvec3>) glUniform3uiv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, uvec4>) glUniform4uiv(Location, Count, Values);
+            else if constexpr (std::is_same_v<T, uvec2>) glUniform2uiv(Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, uvec3>) glUniform3uiv(Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, uvec4>) glUniform4uiv(Location, Count, glm::value_ptr(*Values));
 
             else if constexpr (std::is_same_v<T, f32>)   glUniform1fv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, vec2>) glUniform2fv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, vec3>) glUniform3fv(Location, Count, Values);
-            else if constexpr (std::is_same_v<T, vec4>) glUniform4fv(Location, Count, Values);
-
-            else if constexpr (std::is_same_v<T, mat2x2>)   glUniformMatrix2fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat3x3>)   glUniformMatrix3fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat4x4>)   glUniformMatrix4fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat2x3>) glUniformMatrix2x3fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat3x2>) glUniformMatrix3x2fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat2x4>) glUniformMatrix2x4fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat4x2>) glUniformMatrix4x2fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat3x4>) glUniformMatrix3x4fv(Location, Count, GL_FALSE, Values);
-            else if constexpr (std::is_same_v<T, mat4x3>) glUniformMatrix4x3fv(Location, Count, GL_FALSE, Values);
+            else if constexpr (std::is_same_v<T, vec2>) glUniform2fv(Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, vec3>) glUniform3fv(Location, Count, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, vec4>) glUniform4fv(Location, Count, glm::value_ptr(*Values));
+
+            else if constexpr (std::is_same_v<T, mat2x2>)   glUniformMatrix2fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat3x3>)   glUniformMatrix3fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat4x4>)   glUniformMatrix4fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat2x3>) glUniformMatrix2x3fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat3x2>) glUniformMatrix3x2fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat2x4>) glUniformMatrix2x4fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat4x2>) glUniformMatrix4x2fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat3x4>) glUniformMatrix3x4fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            else if constexpr (std::is_same_v<T, mat4x3>) glUniformMatrix4x3fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
             else static_assert(sizeof(T) == 0, "Unsupported uniform type");
         }
 
-        bool LogShaderCompilationStatus(GLuint Shader);
-        bool LogProgramLinkStatus();
+        //exchanges the GL program and everything reflected from it, used to hot swap a rebuilt program
+        //under the same object so pointers to it stay valid
+        void Swap(ShaderProgram& Other);
+
+        //both append the info log to InfoLog on failure as well as printing it
+        static bool LogShaderCompilationStatus(GLuint Shader, std::string& InfoLog);
+        static bool LogProgramLinkStatus(GLuint Program, std::string& InfoLog);
     };
 }
 
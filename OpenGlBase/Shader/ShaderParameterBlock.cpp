@@ -0,0 +1,62 @@
+#include "ShaderParameterBlock.h"
+#include "../Debug/Log.h"
+#include <algorithm>
+#include <cassert>
+
+namespace Base
+{
+    ShaderParameterBinding::ShaderParameterBinding(ShaderProgram& Program, std::initializer_list<ShaderParameter> Parameters)
+        : Program(Program), Parameters(Parameters)
+    {
+        Resolve();
+    }
+
+    void ShaderParameterBinding::Apply(const void* Data)
+    {
+        if (Generation != Program.GetGeneration())
+            Resolve();
+
+        const u8* Bytes = static_cast<const u8*>(Data);
+
+        for (const BoundParameter& Parameter : Bound)
+            Program.UploadUniformData(Parameter.Location, Bytes + Parameter.Offset, Parameter.Count);
+    }
+
+    ShaderProgram& ShaderParameterBinding::GetProgram() const
+    {
+        return Program;
+    }
+
+    std::size_t ShaderParameterBinding::GetBoundCount() const
+    {
+        return Bound.size();
+    }
+
+    void ShaderParameterBinding::Resolve()
+    {
+        Bound.clear();
+        Generation = Program.GetGeneration();
+
+        for (const ShaderParameter& Parameter : Parameters)
+        {
+            GLint Location = Program.GetUniformLocation(UniformName::FromString(Parameter.Name.c_str()));
+            if (Location == -1)
+                continue;
+
+            const ShaderProgram::UniformShadow& Shadow = Program.UniformShadows[Location];
+
+            //the thunk reads ElementSize bytes per element, anything else would read past the member
+            if (!Parameter.IsCompatible(Shadow.Type) || Shadow.ElementSize != Parameter.ElementSize || Shadow.Upload == nullptr)
+            {
+                Log::Error<LogCategory::Shader>("Parameter {} is a {} but the uniform is a {}", Parameter.Name, GetUniformTypeName(Parameter.Type), GetUniformTypeName(Shadow.Type));
+                assert(false && "Shader parameter doesn't match its uniform");
+                continue;
+            }
+
+            //a longer member array only fills what the shader declares
+            GLsizei Count = std::min(Parameter.Count, static_cast<GLsizei>(Shadow.ElementCount));
+
+            Bound.push_back({ Location, Parameter.Offset, Count });
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <type_traits>
+#include <initializer_list>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "ShaderManager.h"
+
+namespace Base
+{
+    //one member of a parameter struct, made with SHADER_PARAMETER
+    struct ShaderParameter
+    {
+        //owned, Resolve looks it up again after every reload and the caller's string may be long gone
+        std::string Name;
+        u32 Offset;
+        u32 ElementSize;
+        GLsizei Count;
+        GLenum Type;
+        bool (*IsCompatible)(GLenum Type);
+
+        template<typename Member>
+        static ShaderParameter Make(const char* Name, std::size_t Offset)
+        {
+            using Element = std::remove_all_extents_t<Member>;
+
+            GLsizei Count = static_cast<GLsizei>(sizeof(Member) / sizeof(Element));
+            return { Name, static_cast<u32>(Offset), sizeof(Element), Count, GetUniformGlType<Element>(), &IsUniformTypeCompatible<Element> };
+        }
+    };
+
+    //the member is matched to the uniform with the same name, arrays fill the uniform array from the start
+    #define SHADER_PARAMETER(Struct, Member) ::Base::ShaderParameter::Make<decltype(Struct::Member)>(#Member, offsetof(Struct, Member))
+    #define SHADER_PARAMETER_NAMED(Struct, Member, UniformName) ::Base::ShaderParameter::Make<decltype(Struct::Member)>(UniformName, offsetof(Struct, Member))
+
+    //the untyped part of ShaderParameterBlock
+    class ShaderParameterBinding
+    {
+    public:
+        ShaderParameterBinding(ShaderProgram& Program, std::initializer_list<ShaderParameter> Parameters);
+
+        void Apply(const void* Data);
+
+        ShaderProgram& GetProgram() const;
+
+        //how many of the parameters the program has an active uniform for
+        std::size_t GetBoundCount() const;
+
+    private:
+        struct BoundParameter
+        {
+            GLint Location = -1;
+            u32 Offset = 0;
+            GLsizei Count = 0;
+        };
+
+        ShaderProgram& Program;
+        std::vector<ShaderParameter> Parameters;
+        std::vector<BoundParameter> Bound;
+        u32 Generation = 0;
+
+        void Resolve();
+    };
+
+    //a plain struct of per draw parameters uploaded with one Apply instead of a SetUniform per member
+    //
+    //  struct DrawParameters { mat4x4 Model; vec4 Tint; f32 Lights[4]; };
+    //  ShaderParameterBlock<DrawParameters> Block(Program, { SHADER_PARAMETER(DrawParameters, Model),
+    //      SHADER_PARAMETER(DrawParameters, Tint), SHADER_PARAMETER(DrawParameters, Lights) });
+    //
+    //names are looked up once when the block is made and again only after a hot reload swaps the program,
+    //Apply then walks the locations and writes the members whose bytes differ from the last write. members
+    //the program doesn't use are skipped and one whose type doesn't match its uniform is reported and left out
+    template<typename T>
+    class ShaderParameterBlock
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>, "Parameter blocks have to be plain structs");
+
+    public:
+        ShaderParameterBlock(ShaderProgram& Program, std::initializer_list<ShaderParameter> Parameters)
+            : Binding(Program, Parameters)
+        {
+        }
+
+        void Apply(const T& Parameters)
+        {
+            Binding.Apply(&Parameters);
+        }
+
+        ShaderProgram& GetProgram() const
+        {
+            return Binding.GetProgram();
+        }
+
+        std::size_t GetBoundCount() const
+        {
+            return Binding.GetBoundCount();
+        }
+
+    private:
+        ShaderParameterBinding Binding;
+    };
+}
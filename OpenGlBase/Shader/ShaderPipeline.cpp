@@ -0,0 +1,179 @@
+#include "ShaderPipeline.h"
+#include "../Util/Hash.h"
+#include "../Debug/Log.h"
+#include <vector>
+#include <cassert>
+
+namespace Base
+{
+    //like the program tracker, nothing is known until the first bind on a thread
+    static thread_local GLuint BoundPipeline = 0;
+    static thread_local bool BoundPipelineKnown = false;
+
+    ShaderPipeline::ShaderPipeline(ShaderProgram* Vertex, ShaderProgram* Fragment, ShaderProgram* Geometry)
+    {
+        assert(GetGlExtensions().SeparateShaderObjects && GetGlExtensions().ProgramUniform);
+        assert(Vertex);
+
+        Stages[0] = Vertex;
+        Stages[1] = Fragment;
+        Stages[2] = Geometry;
+
+        glGenProgramPipelines(1, &Pipeline);
+
+        for (ShaderProgram* Stage : Stages)
+        {
+            if (Stage == nullptr)
+                continue;
+
+            assert(Stage->IsSeparable());
+            glUseProgramStages(Pipeline, Stage->GetStages(), Stage->GetInstance());
+        }
+    }
+
+    ShaderPipeline::~ShaderPipeline()
+    {
+        //deleting the bound pipeline reverts the binding to zero
+        if (BoundPipelineKnown && BoundPipeline == Pipeline)
+            BoundPipeline = 0;
+
+        glDeleteProgramPipelines(1, &Pipeline);
+    }
+
+    void ShaderPipeline::Use()
+    {
+        ShaderProgram::Unbind();
+
+        if (BoundPipelineKnown && BoundPipeline == Pipeline)
+            return;
+
+        glBindProgramPipeline(Pipeline);
+        BoundPipeline = Pipeline;
+        BoundPipelineKnown = true;
+    }
+
+    void ShaderPipeline::ResetBoundPipeline()
+    {
+        BoundPipelineKnown = false;
+    }
+
+    GLuint ShaderPipeline::GetInstance() const
+    {
+        return Pipeline;
+    }
+
+    bool ShaderPipeline::Validate()
+    {
+        glValidateProgramPipeline(Pipeline);
+
+        GLint Valid = GL_FALSE;
+        glGetProgramPipelineiv(Pipeline, GL_VALIDATE_STATUS, &Valid);
+
+        if (!Valid)
+        {
+            GLint LogLength = 0;
+            glGetProgramPipelineiv(Pipeline, GL_INFO_LOG_LENGTH, &LogLength);
+
+            std::vector<char> InfoLog;
+            InfoLog.resize(LogLength + 1);
+
+            glGetProgramPipelineInfoLog(Pipeline, static_cast<GLsizei>(InfoLog.size()), nullptr, InfoLog.data());
+
+            Log::Warning<LogCategory::Shader>("Program pipeline failed to validate:\n{}", InfoLog.data());
+            return false;
+        }
+
+        return true;
+    }
+
+    ShaderProgram* ShaderPipeline::GetVertexStage() const
+    {
+        return Stages[0];
+    }
+
+    ShaderProgram* ShaderPipeline::GetFragmentStage() const
+    {
+        return Stages[1];
+    }
+
+    ShaderProgram* ShaderPipeline::GetGeometryStage() const
+    {
+        return Stages[2];
+    }
+
+    ShaderStageCache::ShaderStageCache(const char* CacheDirectory)
+    {
+        if (CacheDirectory != nullptr)
+            this->CacheDirectory = CacheDirectory;
+    }
+
+    ShaderProgram* ShaderStageCache::GetStage(GLenum Stage, const char* Source)
+    {
+        assert(Source);
+
+        u64 Key = HashString(Source, HashBytes(&Stage, sizeof(Stage)));
+
+        auto Iterator = Stages.find(Key);
+        if (Iterator != Stages.end())
+        {
+            Stats.StageHits++;
+            return Iterator->second.get();
+        }
+
+        ShaderProgramConfig Config = {};
+        Config.Separable = true;
+        Config.CacheDirectory = CacheDirectory.empty() ? nullptr : CacheDirectory.c_str();
+
+        switch (Stage)
+        {
+            case(GL_VERTEX_SHADER): Config.VertexSource = Source; break;
+            case(GL_FRAGMENT_SHADER): Config.FragmentSource = Source; break;
+            case(GL_GEOMETRY_SHADER): Config.GeometrySource = Source; break;
+            default: assert(false && "Unsupported pipeline stage"); return nullptr;
+        }
+
+        Stats.StagesCompiled++;
+
+        //failures are stored as null so a broken source isn't recompiled every time it's asked for
+        std::unique_ptr<ShaderProgram>& Program = Stages[Key];
+        Program = ShaderProgram::TryCreate(Config);
+
+        return Program.get();
+    }
+
+    ShaderPipeline* ShaderStageCache::GetPipeline(const ShaderProgramConfig& Config)
+    {
+        assert(Config.VertexSource);
+        assert(!Config.ComputeSource);
+
+        ShaderProgram* Vertex = GetStage(GL_VERTEX_SHADER, Config.VertexSource);
+        ShaderProgram* Fragment = Config.FragmentSource ? GetStage(GL_FRAGMENT_SHADER, Config.FragmentSource) : nullptr;
+        ShaderProgram* Geometry = Config.GeometrySource ? GetStage(GL_GEOMETRY_SHADER, Config.GeometrySource) : nullptr;
+
+        if (!Vertex || (Config.FragmentSource && !Fragment) || (Config.GeometrySource && !Geometry))
+            return nullptr;
+
+        //stage programs never move while the cache is alive so their addresses identify them
+        ShaderProgram* Combination[] = { Vertex, Fragment, Geometry };
+        u64 Key = HashBytes(Combination, sizeof(Combination));
+
+        auto Iterator = Pipelines.find(Key);
+        if (Iterator != Pipelines.end())
+        {
+            Stats.PipelineHits++;
+            return Iterator->second.get();
+        }
+
+        Stats.PipelinesCreated++;
+
+        std::unique_ptr<ShaderPipeline>& Pipeline = Pipelines[Key];
+        Pipeline = std::make_unique<ShaderPipeline>(Vertex, Fragment, Geometry);
+
+        return Pipeline.get();
+    }
+
+    const ShaderStageCacheStats& ShaderStageCache::GetStats() const
+    {
+        return Stats;
+    }
+}
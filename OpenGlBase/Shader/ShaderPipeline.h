@@ -0,0 +1,115 @@
+#pragma once
+#include <glad/glad.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ShaderManager.h"
+#include "../Gl/GlExtensions.h"
+
+namespace Base
+{
+    //a program pipeline object combining separable single stage programs, the stages aren't owned
+    //and have to outlive the pipeline, which ShaderStageCache takes care of
+    class ShaderPipeline
+    {
+    public:
+        ShaderPipeline(const ShaderPipeline&) = delete;
+        ShaderPipeline& operator=(const ShaderPipeline&) = delete;
+
+        //stages may be null except for the vertex stage
+        ShaderPipeline(ShaderProgram* Vertex, ShaderProgram* Fragment, ShaderProgram* Geometry = nullptr);
+        ~ShaderPipeline();
+
+        //a program made current with ShaderProgram::Use overrides any bound pipeline so this clears it,
+        //both binds are skipped when they wouldn't change anything
+        void Use();
+        GLuint GetInstance() const;
+
+        //forgets which pipeline is bound, for code that calls glBindProgramPipeline itself or makes a
+        //context current on another thread
+        static void ResetBoundPipeline();
+
+        //checks the stage interfaces match up, logs the info log when they don't
+        bool Validate();
+
+        ShaderProgram* GetVertexStage() const;
+        ShaderProgram* GetFragmentStage() const;
+        ShaderProgram* GetGeometryStage() const;
+
+        //sets the uniform on every stage that declares it, separable programs always come with
+        //glProgramUniform so the pipeline doesn't have to be bound
+        template<typename T>
+        bool SetUniform(UniformName Name, const T& Value)
+        {
+            bool Found = false;
+
+            for (ShaderProgram* Stage : Stages)
+            {
+                if (Stage != nullptr)
+                    Found |= Stage->SetUniform(Name, Value);
+            }
+
+            return Found;
+        }
+
+        template<typename T>
+        bool SetUniform(UniformName Name, const T* Values, const GLsizei Count)
+        {
+            bool Found = false;
+
+            for (ShaderProgram* Stage : Stages)
+            {
+                if (Stage != nullptr)
+                    Found |= Stage->SetUniform(Name, Values, Count);
+            }
+
+            return Found;
+        }
+
+    private:
+        GLuint Pipeline = 0;
+
+        //vertex, fragment, geometry
+        ShaderProgram* Stages[3] = {};
+    };
+
+    struct ShaderStageCacheStats
+    {
+        u64 StagesCompiled = 0;
+        u64 StageHits = 0;
+        u64 PipelinesCreated = 0;
+        u64 PipelineHits = 0;
+    };
+
+    //compiles every distinct stage source once as a separable program and combines them into pipelines
+    //on demand, so N vertex shaders and M fragment shaders cost N + M compiles and no combined links
+    //
+    //stages are keyed by the hash of their type and source and pipelines by the stages they use, both
+    //live as long as the cache. a stage that fails to compile is remembered and not retried
+    class ShaderStageCache
+    {
+    public:
+        ShaderStageCache(const ShaderStageCache&) = delete;
+        ShaderStageCache& operator=(const ShaderStageCache&) = delete;
+
+        //CacheDirectory is passed on to every stage program for the binary cache
+        ShaderStageCache(const char* CacheDirectory = nullptr);
+        ~ShaderStageCache() = default;
+
+        //Stage is GL_VERTEX_SHADER, GL_FRAGMENT_SHADER or GL_GEOMETRY_SHADER, null if it fails to compile
+        ShaderProgram* GetStage(GLenum Stage, const char* Source);
+
+        //the same sources a monolithic ShaderProgram would take, null if any stage fails
+        ShaderPipeline* GetPipeline(const ShaderProgramConfig& Config);
+
+        const ShaderStageCacheStats& GetStats() const;
+
+    private:
+        std::string CacheDirectory;
+
+        std::unordered_map<u64, std::unique_ptr<ShaderProgram>> Stages;
+        std::unordered_map<u64, std::unique_ptr<ShaderPipeline>> Pipelines;
+        ShaderStageCacheStats Stats;
+    };
+}
@@ -0,0 +1,636 @@
+#include "ShaderPreprocessor.h"
+#include "../Util/Hash.h"
+#include "../Debug/Log.h"
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+
+namespace Base
+{
+    static bool IsSpace(char Character)
+    {
+        return Character == ' ' || Character == '\t' || Character == '\r' || Character == '\v' || Character == '\f';
+    }
+
+    static std::string Trim(const std::string& String)
+    {
+        std::size_t Begin = 0;
+        std::size_t End = String.size();
+
+        while (Begin < End && IsSpace(String[Begin])) Begin++;
+        while (End > Begin && IsSpace(String[End - 1])) End--;
+
+        return String.substr(Begin, End - Begin);
+    }
+
+    //replaces comments with a single space, newlines inside block comments are kept so line numbers still match
+    static std::string StripComments(const std::string& Source)
+    {
+        std::string Result;
+        Result.reserve(Source.size());
+
+        std::size_t i = 0;
+        while (i < Source.size())
+        {
+            if (Source[i] == '/' && i + 1 < Source.size() && Source[i + 1] == '/')
+            {
+                while (i < Source.size() && Source[i] != '\n') i++;
+                continue;
+            }
+
+            if (Source[i] == '/' && i + 1 < Source.size() && Source[i + 1] == '*')
+            {
+                i += 2;
+                while (i < Source.size() && !(Source[i] == '*' && i + 1 < Source.size() && Source[i + 1] == '/'))
+                {
+                    if (Source[i] == '\n') Result += '\n';
+                    i++;
+                }
+
+                i += 2;
+                Result += ' ';
+                continue;
+            }
+
+            Result += Source[i++];
+        }
+
+        return Result;
+    }
+
+    //splits "#  word rest" into its parts, false when the line isn't a directive
+    static bool ParseDirective(const std::string& Line, std::string& Word, std::string& Rest)
+    {
+        std::size_t i = 0;
+        while (i < Line.size() && IsSpace(Line[i])) i++;
+
+        if (i >= Line.size() || Line[i] != '#')
+            return false;
+
+        i++;
+        while (i < Line.size() && IsSpace(Line[i])) i++;
+
+        std::size_t WordBegin = i;
+        while (i < Line.size() && (std::isalnum(static_cast<unsigned char>(Line[i])) || Line[i] == '_')) i++;
+
+        Word = Line.substr(WordBegin, i - WordBegin);
+        Rest = Trim(Line.substr(i));
+
+        return true;
+    }
+
+    static bool IsIdentifier(const std::string& String)
+    {
+        if (String.empty() || std::isdigit(static_cast<unsigned char>(String[0])))
+            return false;
+
+        for (char Character : String)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(Character)) && Character != '_')
+                return false;
+        }
+
+        return true;
+    }
+
+    using KnownDefines = std::unordered_map<std::string, const std::string*>;
+    using UndecidedDefines = std::unordered_set<std::string>;
+
+    //1 or 0 when Name is certainly defined or not, -1 when only the compiler knows. GL_ and __ names are
+    //left alone too, extension macros and __VERSION__ depend on the driver
+    static int IsDefined(const std::string& Name, const KnownDefines& Known, const UndecidedDefines& Undecided)
+    {
+        if (!IsIdentifier(Name) || Undecided.count(Name) != 0 || Name.rfind("GL_", 0) == 0 || Name.rfind("__", 0) == 0)
+            return -1;
+
+        return Known.find(Name) != Known.end() ? 1 : 0;
+    }
+
+    //1 or 0 when the condition only depends on known defines or literals, -1 when the compiler has to decide
+    static int EvaluateCondition(const std::string& Word, const std::string& Expression, const KnownDefines& Known, const UndecidedDefines& Undecided)
+    {
+        if (Word == "ifdef" || Word == "ifndef")
+        {
+            int Defined = IsDefined(Expression, Known, Undecided);
+            if (Defined == -1)
+                return -1;
+
+            return Word == "ifdef" ? Defined : 1 - Defined;
+        }
+
+        std::string Condition = Expression;
+        bool Negate = false;
+
+        if (!Condition.empty() && Condition[0] == '!')
+        {
+            Negate = true;
+            Condition = Trim(Condition.substr(1));
+        }
+
+        int Result = -1;
+
+        if (Condition.rfind("defined", 0) == 0)
+        {
+            std::string Name = Trim(Condition.substr(7));
+            if (Name.size() >= 2 && Name.front() == '(' && Name.back() == ')')
+                Name = Trim(Name.substr(1, Name.size() - 2));
+
+            Result = IsDefined(Name, Known, Undecided);
+        }
+        else
+        {
+            const std::string* Value = &Condition;
+
+            if (IsIdentifier(Condition))
+            {
+                auto Iterator = Known.find(Condition);
+                if (Iterator == Known.end() || Iterator->second == nullptr)
+                    return -1;
+
+                Value = Iterator->second;
+            }
+
+            char* End = nullptr;
+            long Number = std::strtol(Value->c_str(), &End, 0);
+
+            if (!Value->empty() && End != nullptr && *End == '\0')
+                Result = Number != 0 ? 1 : 0;
+        }
+
+        if (Result == -1)
+            return -1;
+
+        return Negate ? 1 - Result : Result;
+    }
+
+    ShaderPreprocessor::ShaderPreprocessor(VirtualFileSystem& FileSystem)
+        : FileSystem(FileSystem)
+    {
+    }
+
+    const PreprocessedShader* ShaderPreprocessor::PreprocessFile(const std::string& Path, const std::vector<ShaderDefine>& Defines)
+    {
+        const ParsedFile* File = LoadFile(Path);
+        if (File == nullptr)
+        {
+            Log::Error<LogCategory::Shader>("Failed to read shader {}", Path);
+            return nullptr;
+        }
+
+        return Finish(*File, FileHashes.at(Path), Path, true, Defines);
+    }
+
+    const PreprocessedShader* ShaderPreprocessor::PreprocessSource(const char* Source, const std::vector<ShaderDefine>& Defines)
+    {
+        assert(Source);
+
+        std::string Contents = Source;
+        u64 ContentHash = HashBytes(Contents.data(), Contents.size());
+
+        return Finish(Parse(Contents, ContentHash), ContentHash, "<source>", false, Defines);
+    }
+
+    void ShaderPreprocessor::InvalidateFile(const std::string& Path)
+    {
+        auto Iterator = FileHashes.find(Path);
+        if (Iterator == FileHashes.end())
+            return;
+
+        u64 ContentHash = Iterator->second;
+        FileHashes.erase(Iterator);
+
+        //another path can hold the same contents and share the parse
+        bool Shared = std::any_of(FileHashes.begin(), FileHashes.end(), [&](const std::pair<const std::string, u64>& Entry)
+        {
+            return Entry.second == ContentHash;
+        });
+
+        if (!Shared)
+            ParsedFiles.erase(ContentHash);
+
+        std::erase_if(Outputs, [&](const std::pair<const u64, PreprocessedShader>& Entry)
+        {
+            const std::vector<std::string>& Files = Entry.second.Files;
+            return std::find(Files.begin(), Files.end(), Path) != Files.end();
+        });
+
+        std::erase_if(Requests, [&](const std::pair<const u64, Request>& Entry)
+        {
+            return Entry.second.Dependencies.count(Path) != 0;
+        });
+    }
+
+    void ShaderPreprocessor::ClearCache()
+    {
+        FileHashes.clear();
+        ParsedFiles.clear();
+        Outputs.clear();
+        Requests.clear();
+    }
+
+    const ShaderPreprocessor::ParsedFile* ShaderPreprocessor::LoadFile(const std::string& Path)
+    {
+        auto Iterator = FileHashes.find(Path);
+        if (Iterator != FileHashes.end())
+            return &ParsedFiles.at(Iterator->second);
+
+        std::string Contents;
+        if (!FileSystem.ReadFile(Path, Contents))
+            return nullptr;
+
+        u64 ContentHash = HashBytes(Contents.data(), Contents.size());
+        FileHashes[Path] = ContentHash;
+
+        return &Parse(Contents, ContentHash);
+    }
+
+    const ShaderPreprocessor::ParsedFile& ShaderPreprocessor::Parse(const std::string& Contents, u64 ContentHash)
+    {
+        auto Iterator = ParsedFiles.find(ContentHash);
+        if (Iterator != ParsedFiles.end())
+            return Iterator->second;
+
+        ParsedFile& File = ParsedFiles[ContentHash];
+
+        std::string Stripped = StripComments(Contents);
+
+        std::size_t LineBegin = 0;
+        while (LineBegin < Stripped.size())
+        {
+            std::size_t LineEnd = Stripped.find('\n', LineBegin);
+            if (LineEnd == std::string::npos) LineEnd = Stripped.size();
+
+            Line& Current = File.Lines.emplace_back();
+            Current.Text = Stripped.substr(LineBegin, LineEnd - LineBegin);
+            LineBegin = LineEnd + 1;
+
+            //trailing whitespace and carriage returns carry nothing
+            while (!Current.Text.empty() && IsSpace(Current.Text.back())) Current.Text.pop_back();
+
+            if (!ParseDirective(Current.Text, Current.Word, Current.Rest))
+                continue;
+
+            if (Current.Word == "include" && Current.Rest.size() >= 2)
+            {
+                char Close = Current.Rest[0] == '<' ? '>' : '"';
+                std::size_t PathEnd = Current.Rest.find(Close, 1);
+
+                if (PathEnd != std::string::npos)
+                    Current.Include = Current.Rest.substr(1, PathEnd - 1);
+            }
+
+            if (Current.Word == "pragma" && Current.Rest == "once")
+            {
+                File.PragmaOnce = true;
+                Current = Line();
+            }
+        }
+
+        FindGuard(File);
+
+        return File;
+    }
+
+    void ShaderPreprocessor::FindGuard(ParsedFile& File)
+    {
+        const std::vector<Line>& Lines = File.Lines;
+
+        std::size_t First = 0;
+        while (First < Lines.size() && Lines[First].Text.empty()) First++;
+
+        std::size_t Second = First + 1;
+        while (Second < Lines.size() && Lines[Second].Text.empty()) Second++;
+
+        if (Second >= Lines.size() || Lines[First].Word != "ifndef" || !IsIdentifier(Lines[First].Rest))
+            return;
+
+        if (Lines[Second].Word != "define" || Lines[Second].Rest != Lines[First].Rest)
+            return;
+
+        //it's only a guard when its #endif closes the file, an #else or anything after it makes it
+        //an ordinary conditional
+        u32 Depth = 0;
+        for (std::size_t i = First; i < Lines.size(); i++)
+        {
+            const std::string& Word = Lines[i].Word;
+
+            if (Word == "if" || Word == "ifdef" || Word == "ifndef")
+            {
+                Depth++;
+            }
+            else if ((Word == "elif" || Word == "else") && Depth == 1)
+            {
+                return;
+            }
+            else if (Word == "endif" && --Depth == 0)
+            {
+                for (std::size_t j = i + 1; j < Lines.size(); j++)
+                {
+                    if (!Lines[j].Text.empty())
+                        return;
+                }
+
+                File.Guard = Lines[First].Rest;
+                return;
+            }
+        }
+    }
+
+    bool ShaderPreprocessor::Expand(const ParsedFile& File, u32 FileIndex, u32 Depth, Expansion& State)
+    {
+        //resolved blocks have their directives removed, unresolved ones are passed through untouched.
+        //a block can't span files so every file starts with its own stack
+        struct Block
+        {
+            bool Resolved;
+            bool ParentActive;
+            bool Taken;
+        };
+
+        std::vector<Block> Blocks;
+        bool Active = true;
+
+        for (u32 i = 0; i < File.Lines.size(); i++)
+        {
+            const Line& Current = File.Lines[i];
+            const std::string& Word = Current.Word;
+            const std::string& Rest = Current.Rest;
+
+            //inactive and resolved lines become empty lines so #line numbering stays correct
+            bool Keep = Active;
+            std::string Rewritten;
+
+            if (Word == "if" || Word == "ifdef" || Word == "ifndef")
+            {
+                int Condition = Active ? EvaluateCondition(Word, Rest, State.Known, State.Undecided) : 0;
+
+                if (Active && Condition == -1)
+                {
+                    Blocks.push_back({ false, true, true });
+                    State.UnresolvedBlocks++;
+                }
+                else
+                {
+                    Blocks.push_back({ true, Active, Condition == 1 });
+                    Active = Active && Condition == 1;
+                    Keep = false;
+                }
+            }
+            else if ((Word == "elif" || Word == "else" || Word == "endif") && !Blocks.empty())
+            {
+                Block& Parent = Blocks.back();
+
+                if (!Parent.Resolved)
+                {
+                    Keep = true;
+                }
+                else if (Word == "elif")
+                {
+                    int Condition = Parent.ParentActive && !Parent.Taken ? EvaluateCondition("if", Rest, State.Known, State.Undecided) : 0;
+
+                    if (Condition == -1)
+                    {
+                        //the rest of the chain can't be decided here, turn it back into a plain #if
+                        //which the original #endif will close
+                        Parent.Resolved = false;
+                        State.UnresolvedBlocks++;
+                        Active = true;
+                        Rewritten = "#if " + Rest;
+                        Keep = true;
+                    }
+                    else
+                    {
+                        Active = Condition == 1;
+                        Parent.Taken = Parent.Taken || Active;
+                        Keep = false;
+                    }
+                }
+                else if (Word == "else")
+                {
+                    Active = Parent.ParentActive && !Parent.Taken;
+                    Parent.Taken = true;
+                    Keep = false;
+                }
+                else
+                {
+                    Active = Parent.ParentActive;
+                    Keep = false;
+                }
+
+                if (Word == "endif")
+                {
+                    if (!Parent.Resolved)
+                        State.UnresolvedBlocks--;
+
+                    Active = Parent.ParentActive;
+                    Blocks.pop_back();
+                }
+            }
+            else if ((Word == "define" || Word == "undef") && Active)
+            {
+                //the value of the shader's own defines is left to the compiler, and inside a block the
+                //compiler decides it isn't even known whether they happen
+                std::size_t NameEnd = 0;
+                while (NameEnd < Rest.size() && (std::isalnum(static_cast<unsigned char>(Rest[NameEnd])) || Rest[NameEnd] == '_')) NameEnd++;
+
+                std::string Name = Rest.substr(0, NameEnd);
+                State.Known.erase(Name);
+
+                if (State.UnresolvedBlocks != 0)
+                {
+                    State.Undecided.insert(Name);
+                }
+                else
+                {
+                    State.Undecided.erase(Name);
+                    if (Word == "define")
+                        State.Known[Name] = nullptr;
+                }
+            }
+            else if (!Current.Include.empty() && Active)
+            {
+                if (!ExpandInclude(Current.Include, i + 2, FileIndex, Depth, State))
+                    return false;
+
+                continue;
+            }
+
+            if (Keep)
+                State.Output += Rewritten.empty() ? Current.Text : Rewritten;
+
+            State.Output += '\n';
+        }
+
+        if (!Blocks.empty())
+        {
+            Log::Error<LogCategory::Shader>("Shader {} ends inside an #if block", State.Files[FileIndex]);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ShaderPreprocessor::ExpandInclude(const std::string& Include, u32 ResumeLine, u32 FileIndex, u32 Depth, Expansion& State)
+    {
+        if (Depth >= MaxIncludeDepth)
+        {
+            Log::Error<LogCategory::Shader>("Shader includes nested deeper than {} levels at {}, is there a cycle?", MaxIncludeDepth, Include);
+            return false;
+        }
+
+        const ParsedFile* Included = LoadFile(Include);
+        if (Included == nullptr)
+        {
+            Log::Error<LogCategory::Shader>("Failed to read shader include {} from {}", Include, State.Files[FileIndex]);
+            return false;
+        }
+
+        //skipped files count too, a changed guard changes what gets skipped
+        State.Dependencies.emplace(Include, FileHashes.at(Include));
+
+        //a guarded file is skipped when its guard is certainly defined or when it includes itself, its
+        //guard is defined by the copy further up no matter what the compiler makes of the blocks around it
+        const std::string& Guard = Included->Guard;
+        bool Guarded = !Guard.empty() && (State.Guards.count(Guard) != 0 || IsDefined(Guard, State.Known, State.Undecided) == 1);
+
+        //stands in for the #include line itself so the lines after it keep their numbers
+        if (Guarded || (Included->PragmaOnce && !State.OnceFiles.insert(Include).second))
+        {
+            State.Output += '\n';
+            return true;
+        }
+
+        u32 IncludedIndex = static_cast<u32>(State.Files.size());
+        State.Files.push_back(Include);
+
+        State.Output += "#line 1 " + std::to_string(IncludedIndex) + "\n";
+
+        if (!Guard.empty())
+            State.Guards.insert(Guard);
+
+        if (!Expand(*Included, IncludedIndex, Depth + 1, State))
+            return false;
+
+        if (!Guard.empty())
+            State.Guards.erase(Guard);
+
+        State.Output += "#line " + std::to_string(ResumeLine) + " " + std::to_string(FileIndex) + "\n";
+        return true;
+    }
+
+    const PreprocessedShader* ShaderPreprocessor::Finish(const ParsedFile& TopFile, u64 TopHash, const std::string& TopName, bool TopIsFile, const std::vector<ShaderDefine>& Defines)
+    {
+        //the same top level contents with the same defines expand the same way as long as none of the
+        //files they pulled in changed, so repeated requests skip the expansion
+        u64 RequestKey = HashBytes(TopName.c_str(), TopName.size() + 1, TopHash);
+
+        for (const ShaderDefine& Define : Defines)
+            RequestKey = HashBytes(Define.Value.c_str(), Define.Value.size() + 1, HashBytes(Define.Name.c_str(), Define.Name.size() + 1, RequestKey));
+
+        auto Found = Requests.find(RequestKey);
+        if (Found != Requests.end())
+        {
+            bool Valid = std::all_of(Found->second.Dependencies.begin(), Found->second.Dependencies.end(), [&](const std::pair<const std::string, u64>& Dependency)
+            {
+                auto Current = FileHashes.find(Dependency.first);
+                return Current != FileHashes.end() && Current->second == Dependency.second;
+            });
+
+            auto Cached = Outputs.find(Found->second.Output);
+            if (Valid && Cached != Outputs.end())
+                return &Cached->second;
+
+            Requests.erase(Found);
+        }
+
+        Expansion State;
+        State.Files = { TopName };
+
+        if (TopIsFile)
+            State.Dependencies.emplace(TopName, TopHash);
+
+        for (const ShaderDefine& Define : Defines)
+            State.Known[Define.Name] = &Define.Value;
+
+        //so a header including the top level file back stops there
+        if (TopFile.PragmaOnce)
+            State.OnceFiles.insert(TopName);
+
+        if (!TopFile.Guard.empty())
+            State.Guards.insert(TopFile.Guard);
+
+        if (!Expand(TopFile, 0, 0, State))
+            return nullptr;
+
+        u64 Key = HashBytes(State.Output.data(), State.Output.size());
+
+        for (const ShaderDefine& Define : Defines)
+            Key = HashBytes(Define.Value.c_str(), Define.Value.size() + 1, HashBytes(Define.Name.c_str(), Define.Name.size() + 1, Key));
+
+        for (const std::string& File : State.Files)
+            Key = HashBytes(File.c_str(), File.size() + 1, Key);
+
+        Request& Memo = Requests[RequestKey];
+        Memo.Output = Key;
+        Memo.Dependencies = std::move(State.Dependencies);
+
+        auto Iterator = Outputs.find(Key);
+        if (Iterator != Outputs.end())
+            return &Iterator->second;
+
+        PreprocessedShader& Output = Outputs[Key];
+        Output.Source = InjectDefines(State.Output, Defines);
+        Output.Files = std::move(State.Files);
+        Output.Hash = Key;
+
+        return &Output;
+    }
+
+    std::string ShaderPreprocessor::InjectDefines(const std::string& Source, const std::vector<ShaderDefine>& Defines)
+    {
+        std::string DefineBlock;
+        for (const ShaderDefine& Define : Defines)
+            DefineBlock += "#define " + Define.Name + " " + Define.Value + "\n";
+
+        //#version has to stay the first thing in the shader, everything else goes after it
+        std::size_t InsertAt = 0;
+        u32 NextLine = 1;
+
+        std::size_t LineBegin = 0;
+        u32 LineNumber = 0;
+
+        while (LineBegin < Source.size())
+        {
+            std::size_t LineEnd = Source.find('\n', LineBegin);
+            if (LineEnd == std::string::npos) LineEnd = Source.size();
+
+            LineNumber++;
+
+            std::string Word;
+            std::string Rest;
+            if (ParseDirective(Source.substr(LineBegin, LineEnd - LineBegin), Word, Rest) && Word == "version")
+            {
+                InsertAt = LineEnd + 1;
+                NextLine = LineNumber + 1;
+                break;
+            }
+
+            //anything but empty lines before #version means there isn't one
+            if (!Trim(Source.substr(LineBegin, LineEnd - LineBegin)).empty())
+                break;
+
+            LineBegin = LineEnd + 1;
+        }
+
+        InsertAt = std::min(InsertAt, Source.size());
+
+        std::string Result;
+        Result.reserve(Source.size() + DefineBlock.size() + 16);
+        Result.append(Source, 0, InsertAt);
+        Result += DefineBlock;
+        Result += "#line " + std::to_string(NextLine) + " 0\n";
+        Result.append(Source, InsertAt, std::string::npos);
+
+        return Result;
+    }
+}
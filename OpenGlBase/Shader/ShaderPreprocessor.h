@@ -0,0 +1,118 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../FileSystem/VirtualFileSystem.h"
+
+namespace Base
+{
+    struct ShaderDefine
+    {
+        std::string Name;
+        std::string Value = "1";
+    };
+
+    struct PreprocessedShader
+    {
+        std::string Source;
+
+        //every file that went into Source, the index is the source string number used in the #line
+        //directives so "2(14)" in an info log is line 14 of Files[2], index 0 is the top level source
+        std::vector<std::string> Files;
+
+        u64 Hash = 0;
+    };
+
+    //expands #include against a VirtualFileSystem, injects #define sets after #version, strips comments
+    //and drops #if/#ifdef blocks that can be decided from the injected defines and the shader's own
+    //#defines. conditionals are resolved while each file is expanded, so nothing in a dropped block is
+    //read, not even an #include. headers are included once when they use #pragma once or an
+    //#ifndef X / #define X ... #endif guard
+    //
+    //files are read and parsed once and kept by content hash. a request is memoized by the content hash
+    //of its top level file and its defines, a repeat only checks that none of the files it pulled in
+    //changed and doesn't expand anything. outputs that come out identical are stored once
+    class ShaderPreprocessor
+    {
+    public:
+        ShaderPreprocessor(const ShaderPreprocessor&) = delete;
+        ShaderPreprocessor& operator=(const ShaderPreprocessor&) = delete;
+
+        ShaderPreprocessor(VirtualFileSystem& FileSystem);
+
+        //includes are relative to the root of the file system, null when a file can't be read
+        //results stay valid until ClearCache or until a file that went into them is invalidated
+        const PreprocessedShader* PreprocessFile(const std::string& Path, const std::vector<ShaderDefine>& Defines = {});
+        const PreprocessedShader* PreprocessSource(const char* Source, const std::vector<ShaderDefine>& Defines = {});
+
+        //forgets what was read from Path and every output that included it so the next expansion picks
+        //up changes
+        void InvalidateFile(const std::string& Path);
+        void ClearCache();
+
+    private:
+        //one line with comments stripped, Word and Rest are only set on directives
+        struct Line
+        {
+            std::string Text;
+            std::string Word;
+            std::string Rest;
+            std::string Include;
+        };
+
+        struct ParsedFile
+        {
+            std::vector<Line> Lines;
+
+            //the X of an #ifndef X / #define X pair wrapping the whole file, empty when there isn't one
+            std::string Guard;
+            bool PragmaOnce = false;
+        };
+
+        struct Expansion
+        {
+            std::string Output;
+            std::vector<std::string> Files;
+            std::unordered_set<std::string> OnceFiles;
+
+            //every file read on the way with its content hash, skipped includes too
+            std::unordered_map<std::string, u64> Dependencies;
+
+            //guards of the files being expanded right now, from the top level down
+            std::unordered_set<std::string> Guards;
+
+            //names that are certainly defined, the value is null for ones the shader defines itself.
+            //Undecided are names defined or undefined inside a block left to the compiler
+            std::unordered_map<std::string, const std::string*> Known;
+            std::unordered_set<std::string> Undecided;
+            u32 UnresolvedBlocks = 0;
+        };
+
+        struct Request
+        {
+            u64 Output = 0;
+            std::unordered_map<std::string, u64> Dependencies;
+        };
+
+        static constexpr u32 MaxIncludeDepth = 32;
+
+        VirtualFileSystem& FileSystem;
+
+        std::unordered_map<std::string, u64> FileHashes;
+        std::unordered_map<u64, ParsedFile> ParsedFiles;
+        std::unordered_map<u64, PreprocessedShader> Outputs;
+        std::unordered_map<u64, Request> Requests;
+
+        const ParsedFile* LoadFile(const std::string& Path);
+        const ParsedFile& Parse(const std::string& Contents, u64 ContentHash);
+
+        bool Expand(const ParsedFile& File, u32 FileIndex, u32 Depth, Expansion& State);
+        bool ExpandInclude(const std::string& Include, u32 ResumeLine, u32 FileIndex, u32 Depth, Expansion& State);
+        const PreprocessedShader* Finish(const ParsedFile& TopFile, u64 TopHash, const std::string& TopName, bool TopIsFile, const std::vector<ShaderDefine>& Defines);
+
+        static void FindGuard(ParsedFile& File);
+        static std::string InjectDefines(const std::string& Source, const std::vector<ShaderDefine>& Defines);
+    };
+}
@@ -0,0 +1,240 @@
+#include "ShaderReflection.h"
+#include "../Gl/GlExtensions.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Base
+{
+    template<typename T>
+    static const T* FindByName(const std::vector<T>& Items, UniformName Name)
+    {
+        for (const T& Item : Items)
+        {
+            if (Item.NameHash == Name.Hash)
+                return &Item;
+        }
+
+        return nullptr;
+    }
+
+    const ReflectedUniform* ShaderReflection::FindUniform(UniformName Name) const
+    {
+        return FindByName(Uniforms, Name);
+    }
+
+    const ReflectedSampler* ShaderReflection::FindSampler(UniformName Name) const
+    {
+        return FindByName(Samplers, Name);
+    }
+
+    const ReflectedAttribute* ShaderReflection::FindAttribute(UniformName Name) const
+    {
+        return FindByName(Attributes, Name);
+    }
+
+    const UniformBlockLayout* ShaderReflection::FindUniformBlock(UniformName Name) const
+    {
+        return FindByName(UniformBlocks, Name);
+    }
+
+    const ShaderStorageBlock* ShaderReflection::FindStorageBlock(UniformName Name) const
+    {
+        return FindByName(StorageBlocks, Name);
+    }
+
+    static void StripArraySuffix(std::string& Name)
+    {
+        if (Name.size() > 3 && Name.compare(Name.size() - 3, 3, "[0]") == 0)
+            Name.erase(Name.size() - 3);
+    }
+
+    std::vector<ReflectedAttribute> ReflectAttributes(GLuint Program)
+    {
+        std::vector<ReflectedAttribute> Attributes;
+
+        GLint AttributeCount = 0;
+        GLint MaxNameLength = 0;
+        glGetProgramiv(Program, GL_ACTIVE_ATTRIBUTES, &AttributeCount);
+        glGetProgramiv(Program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &MaxNameLength);
+
+        std::vector<char> Name;
+        Name.resize(MaxNameLength + 1);
+
+        for (GLint i = 0; i < AttributeCount; i++)
+        {
+            GLsizei NameLength = 0;
+            GLint ArraySize = 0;
+            GLenum Type = 0;
+            glGetActiveAttrib(Program, static_cast<GLuint>(i), static_cast<GLsizei>(Name.size()), &NameLength, &ArraySize, &Type, Name.data());
+
+            //built in inputs like gl_VertexID are listed too but have no location
+            GLint Location = glGetAttribLocation(Program, Name.data());
+            if (Location == -1)
+                continue;
+
+            ReflectedAttribute& Attribute = Attributes.emplace_back();
+            Attribute.Name.assign(Name.data(), NameLength);
+            StripArraySuffix(Attribute.Name);
+            Attribute.NameHash = HashString(Attribute.Name.c_str());
+            Attribute.Type = Type;
+            Attribute.ArraySize = ArraySize;
+            Attribute.Location = Location;
+        }
+
+        std::sort(Attributes.begin(), Attributes.end(), [](const ReflectedAttribute& A, const ReflectedAttribute& B) { return A.Location < B.Location; });
+
+        return Attributes;
+    }
+
+    std::vector<ShaderStorageBlock> ReflectStorageBlocks(GLuint Program)
+    {
+        std::vector<ShaderStorageBlock> Blocks;
+
+        GLint BlockCount = 0;
+        GLint MaxBlockNameLength = 0;
+        GLint MaxVariableNameLength = 0;
+        glGetProgramInterfaceiv(Program, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &BlockCount);
+        glGetProgramInterfaceiv(Program, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &MaxBlockNameLength);
+        glGetProgramInterfaceiv(Program, GL_BUFFER_VARIABLE, GL_MAX_NAME_LENGTH, &MaxVariableNameLength);
+
+        std::vector<char> Name;
+        Name.resize(std::max(MaxBlockNameLength, MaxVariableNameLength) + 1);
+
+        const GLenum BlockProperties[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
+        const GLenum VariableProperties[] = { GL_TYPE, GL_OFFSET, GL_ARRAY_SIZE, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR };
+        constexpr GLsizei VariablePropertyCount = static_cast<GLsizei>(std::size(VariableProperties));
+
+        for (GLint i = 0; i < BlockCount; i++)
+        {
+            ShaderStorageBlock& Block = Blocks.emplace_back();
+            Block.Index = static_cast<GLuint>(i);
+
+            GLsizei NameLength = 0;
+            glGetProgramResourceName(Program, GL_SHADER_STORAGE_BLOCK, Block.Index, static_cast<GLsizei>(Name.size()), &NameLength, Name.data());
+            Block.Name.assign(Name.data(), NameLength);
+            Block.NameHash = HashString(Block.Name.c_str());
+
+            GLint Values[3] = {};
+            glGetProgramResourceiv(Program, GL_SHADER_STORAGE_BLOCK, Block.Index, 3, BlockProperties, 3, nullptr, Values);
+            Block.Binding = Values[0];
+            Block.DataSize = Values[1];
+
+            GLint VariableCount = Values[2];
+            if (VariableCount <= 0)
+                continue;
+
+            const GLenum ActiveVariables = GL_ACTIVE_VARIABLES;
+            std::vector<GLint> Variables(VariableCount);
+            glGetProgramResourceiv(Program, GL_SHADER_STORAGE_BLOCK, Block.Index, 1, &ActiveVariables, VariableCount, nullptr, Variables.data());
+
+            for (GLint Variable : Variables)
+            {
+                GLint Properties[VariablePropertyCount] = {};
+                glGetProgramResourceiv(Program, GL_BUFFER_VARIABLE, static_cast<GLuint>(Variable), VariablePropertyCount, VariableProperties, VariablePropertyCount, nullptr, Properties);
+
+                glGetProgramResourceName(Program, GL_BUFFER_VARIABLE, static_cast<GLuint>(Variable), static_cast<GLsizei>(Name.size()), &NameLength, Name.data());
+
+                UniformBlockMember& Member = Block.Members.emplace_back();
+                Member.Name.assign(Name.data(), NameLength);
+
+                //same naming as uniform block members, "BlockName.Member[0]" becomes "Member"
+                std::string Prefix = Block.Name + ".";
+                if (Member.Name.compare(0, Prefix.size(), Prefix) == 0)
+                    Member.Name.erase(0, Prefix.size());
+
+                StripArraySuffix(Member.Name);
+
+                Member.Type = static_cast<GLenum>(Properties[0]);
+                Member.Offset = Properties[1];
+                Member.ArraySize = Properties[2];
+                Member.ArrayStride = Properties[3];
+                Member.MatrixStride = Properties[4];
+                Member.RowMajor = Properties[5] != 0;
+            }
+
+            std::sort(Block.Members.begin(), Block.Members.end(), [](const UniformBlockMember& A, const UniformBlockMember& B) { return A.Offset < B.Offset; });
+        }
+
+        return Blocks;
+    }
+
+    const char* GetUniformTypeName(GLenum Type)
+    {
+        switch (Type)
+        {
+            case(GL_FLOAT): return "float";
+            case(GL_FLOAT_VEC2): return "vec2";
+            case(GL_FLOAT_VEC3): return "vec3";
+            case(GL_FLOAT_VEC4): return "vec4";
+            case(GL_INT): return "int";
+            case(GL_INT_VEC2): return "ivec2";
+            case(GL_INT_VEC3): return "ivec3";
+            case(GL_INT_VEC4): return "ivec4";
+            case(GL_UNSIGNED_INT): return "uint";
+            case(GL_UNSIGNED_INT_VEC2): return "uvec2";
+            case(GL_UNSIGNED_INT_VEC3): return "uvec3";
+            case(GL_UNSIGNED_INT_VEC4): return "uvec4";
+            case(GL_BOOL): return "bool";
+            case(GL_BOOL_VEC2): return "bvec2";
+            case(GL_BOOL_VEC3): return "bvec3";
+            case(GL_BOOL_VEC4): return "bvec4";
+            case(GL_FLOAT_MAT2): return "mat2";
+            case(GL_FLOAT_MAT3): return "mat3";
+            case(GL_FLOAT_MAT4): return "mat4";
+            case(GL_FLOAT_MAT2x3): return "mat2x3";
+            case(GL_FLOAT_MAT2x4): return "mat2x4";
+            case(GL_FLOAT_MAT3x2): return "mat3x2";
+            case(GL_FLOAT_MAT3x4): return "mat3x4";
+            case(GL_FLOAT_MAT4x2): return "mat4x2";
+            case(GL_FLOAT_MAT4x3): return "mat4x3";
+        }
+
+        if (IsSamplerType(Type)) return "sampler";
+        if (IsImageType(Type)) return "image";
+
+        return "unknown";
+    }
+
+    u32 GetUniformTypeSize(GLenum Type)
+    {
+        switch (Type)
+        {
+            case(GL_FLOAT): return sizeof(f32);
+            case(GL_FLOAT_VEC2): return sizeof(f32) * 2;
+            case(GL_FLOAT_VEC3): return sizeof(f32) * 3;
+            case(GL_FLOAT_VEC4): return sizeof(f32) * 4;
+            case(GL_INT): case(GL_BOOL): return sizeof(i32);
+            case(GL_INT_VEC2): case(GL_BOOL_VEC2): return sizeof(i32) * 2;
+            case(GL_INT_VEC3): case(GL_BOOL_VEC3): return sizeof(i32) * 3;
+            case(GL_INT_VEC4): case(GL_BOOL_VEC4): return sizeof(i32) * 4;
+            case(GL_UNSIGNED_INT): return sizeof(u32);
+            case(GL_UNSIGNED_INT_VEC2): return sizeof(u32) * 2;
+            case(GL_UNSIGNED_INT_VEC3): return sizeof(u32) * 3;
+            case(GL_UNSIGNED_INT_VEC4): return sizeof(u32) * 4;
+            case(GL_FLOAT_MAT2): return sizeof(f32) * 4;
+            case(GL_FLOAT_MAT3): return sizeof(f32) * 9;
+            case(GL_FLOAT_MAT4): return sizeof(f32) * 16;
+            case(GL_FLOAT_MAT2x3): case(GL_FLOAT_MAT3x2): return sizeof(f32) * 6;
+            case(GL_FLOAT_MAT2x4): case(GL_FLOAT_MAT4x2): return sizeof(f32) * 8;
+            case(GL_FLOAT_MAT3x4): case(GL_FLOAT_MAT4x3): return sizeof(f32) * 12;
+        }
+
+        //samplers and images are set through glUniform1i
+        return sizeof(i32);
+    }
+
+    bool IsSamplerType(GLenum Type)
+    {
+        //the sampler enums are spread over a few blocks, the uint vector types sit in the middle of one
+        return (Type >= 0x8B5D && Type <= 0x8B64)     //GL_SAMPLER_1D to GL_SAMPLER_2D_RECT_SHADOW
+            || (Type >= 0x8DC0 && Type <= 0x8DC5)     //GL_SAMPLER_1D_ARRAY to GL_SAMPLER_CUBE_SHADOW
+            || (Type >= 0x8DC9 && Type <= 0x8DD8)     //GL_INT_SAMPLER_1D to GL_UNSIGNED_INT_SAMPLER_BUFFER
+            || (Type >= 0x900C && Type <= 0x900F)     //GL_SAMPLER_CUBE_MAP_ARRAY and its variants
+            || (Type >= 0x9108 && Type <= 0x910D);    //GL_SAMPLER_2D_MULTISAMPLE and its variants
+    }
+
+    bool IsImageType(GLenum Type)
+    {
+        return Type >= 0x904C && Type <= 0x906C;      //GL_IMAGE_1D to GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY
+    }
+}
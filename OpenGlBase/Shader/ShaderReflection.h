@@ -0,0 +1,140 @@
+#pragma once
+#include <glad/glad.h>
+#include <type_traits>
+#include <string>
+#include <vector>
+
+#include "UniformName.h"
+#include "UniformBlock.h"
+
+namespace Base
+{
+    //a uniform in the default block, arrays are reported once under their name without "[0]"
+    struct ReflectedUniform
+    {
+        std::string Name;
+        u64 NameHash = 0;
+        GLenum Type = 0;
+        GLint ArraySize = 1;
+        GLint Location = -1;
+    };
+
+    //samplers and images are also listed in Uniforms, Unit is the texture or image unit they were
+    //pointed at when the program linked, zero unless the shader gives them a binding
+    struct ReflectedSampler
+    {
+        std::string Name;
+        u64 NameHash = 0;
+        GLenum Type = 0;
+        GLint ArraySize = 1;
+        GLint Location = -1;
+        GLint Unit = 0;
+    };
+
+    struct ReflectedAttribute
+    {
+        std::string Name;
+        u64 NameHash = 0;
+        GLenum Type = 0;
+        GLint ArraySize = 1;
+        GLint Location = -1;
+    };
+
+    struct ShaderStorageBlock
+    {
+        std::string Name;
+        u64 NameHash = 0;
+        GLuint Index = 0;
+        GLint Binding = 0;
+
+        //size of the fixed part, a trailing unsized array adds to it per element
+        GLint DataSize = 0;
+
+        //sorted by offset, a trailing unsized array has an ArraySize of zero
+        std::vector<UniformBlockMember> Members;
+    };
+
+    //everything the driver reports about a linked program, filled in once after linking
+    struct ShaderReflection
+    {
+        std::vector<ReflectedUniform> Uniforms;
+        std::vector<ReflectedSampler> Samplers;
+        std::vector<ReflectedAttribute> Attributes;
+        std::vector<UniformBlockLayout> UniformBlocks;
+
+        //empty without GetGlExtensions().ShaderStorageBuffer
+        std::vector<ShaderStorageBlock> StorageBlocks;
+
+        const ReflectedUniform* FindUniform(UniformName Name) const;
+        const ReflectedSampler* FindSampler(UniformName Name) const;
+        const ReflectedAttribute* FindAttribute(UniformName Name) const;
+        const UniformBlockLayout* FindUniformBlock(UniformName Name) const;
+        const ShaderStorageBlock* FindStorageBlock(UniformName Name) const;
+    };
+
+    std::vector<ReflectedAttribute> ReflectAttributes(GLuint Program);
+
+    //needs GetGlExtensions().ShaderStorageBuffer
+    std::vector<ShaderStorageBlock> ReflectStorageBlocks(GLuint Program);
+
+    //GLSL spelling of a reflected type for messages, "sampler" or "image" for any opaque type
+    const char* GetUniformTypeName(GLenum Type);
+
+    //size in bytes of one element as it is passed to glUniform*, opaque types are set as one int
+    u32 GetUniformTypeSize(GLenum Type);
+
+    bool IsSamplerType(GLenum Type);
+    bool IsImageType(GLenum Type);
+
+    //the reflected type a C++ uniform type uploads as
+    template<typename T>
+    constexpr GLenum GetUniformGlType()
+    {
+        if      constexpr (std::is_same_v<T, i32>)   return GL_INT;
+        else if constexpr (std::is_same_v<T, ivec2>) return GL_INT_VEC2;
+        else if constexpr (std::is_same_v<T, ivec3>) return GL_INT_VEC3;
+        else if constexpr (std::is_same_v<T, ivec4>) return GL_INT_VEC4;
+
+        else if constexpr (std::is_same_v<T, u32>)   return GL_UNSIGNED_INT;
+        else if constexpr (std::is_same_v<T, uvec2>) return GL_UNSIGNED_INT_VEC2;
+        else if constexpr (std::is_same_v<T, uvec3>) return GL_UNSIGNED_INT_VEC3;
+        else if constexpr (std::is_same_v<T, uvec4>) return GL_UNSIGNED_INT_VEC4;
+
+        else if constexpr (std::is_same_v<T, f32>)   return GL_FLOAT;
+        else if constexpr (std::is_same_v<T, vec2>) return GL_FLOAT_VEC2;
+        else if constexpr (std::is_same_v<T, vec3>) return GL_FLOAT_VEC3;
+        else if constexpr (std::is_same_v<T, vec4>) return GL_FLOAT_VEC4;
+
+        else if constexpr (std::is_same_v<T, mat2x2>) return GL_FLOAT_MAT2;
+        else if constexpr (std::is_same_v<T, mat3x3>) return GL_FLOAT_MAT3;
+        else if constexpr (std::is_same_v<T, mat4x4>) return GL_FLOAT_MAT4;
+        else if constexpr (std::is_same_v<T, mat2x3>) return GL_FLOAT_MAT2x3;
+        else if constexpr (std::is_same_v<T, mat3x2>) return GL_FLOAT_MAT3x2;
+        else if constexpr (std::is_same_v<T, mat2x4>) return GL_FLOAT_MAT2x4;
+        else if constexpr (std::is_same_v<T, mat4x2>) return GL_FLOAT_MAT4x2;
+        else if constexpr (std::is_same_v<T, mat3x4>) return GL_FLOAT_MAT3x4;
+        else if constexpr (std::is_same_v<T, mat4x3>) return GL_FLOAT_MAT4x3;
+        else static_assert(sizeof(T) == 0, "Unsupported uniform type");
+    }
+
+    //whether glUniform* for T is allowed on a uniform of Type, bools take any scalar or vector type with
+    //the same number of components and samplers and images are set with a single int
+    template<typename T>
+    bool IsUniformTypeCompatible(GLenum Type)
+    {
+        constexpr GLenum Expected = GetUniformGlType<T>();
+
+        if (Type == Expected)
+            return true;
+
+        switch (Type)
+        {
+            case(GL_BOOL): return Expected == GL_INT || Expected == GL_UNSIGNED_INT || Expected == GL_FLOAT;
+            case(GL_BOOL_VEC2): return Expected == GL_INT_VEC2 || Expected == GL_UNSIGNED_INT_VEC2 || Expected == GL_FLOAT_VEC2;
+            case(GL_BOOL_VEC3): return Expected == GL_INT_VEC3 || Expected == GL_UNSIGNED_INT_VEC3 || Expected == GL_FLOAT_VEC3;
+            case(GL_BOOL_VEC4): return Expected == GL_INT_VEC4 || Expected == GL_UNSIGNED_INT_VEC4 || Expected == GL_FLOAT_VEC4;
+        }
+
+        return Expected == GL_INT && (IsSamplerType(Type) || IsImageType(Type));
+    }
+}
@@ -0,0 +1,274 @@
+#include "ShaderVariantSet.h"
+#include "../Util/Hash.h"
+#include "../Debug/Log.h"
+#include <fstream>
+#include <cstring>
+
+namespace Base
+{
+    ShaderVariantSet::ShaderVariantSet(ShaderPreprocessor& Preprocessor, const ShaderProgramConfig& Config, const std::vector<ShaderKeyword>& Keywords)
+        : Preprocessor(Preprocessor)
+    {
+        assert(Config.Separable || Config.ComputeSource || (Config.VertexSource && Config.FragmentSource));
+
+        const char* ConfigSources[] = { Config.VertexSource, Config.FragmentSource, Config.GeometrySource, Config.ComputeSource };
+
+        for (u32 i = 0; i < StageCount; i++)
+        {
+            if (ConfigSources[i] == nullptr)
+                continue;
+
+            Sources[i] = ConfigSources[i];
+            HasStage[i] = true;
+        }
+
+        if (Config.CacheDirectory != nullptr)
+            CacheDirectory = Config.CacheDirectory;
+
+        Separable = Config.Separable;
+
+        u32 Shift = 0;
+        Signature = HashOffsetBasis;
+
+        for (const ShaderKeyword& Keyword : Keywords)
+        {
+            //booleans take one bit, enums as many as their value count needs
+            u32 ValueCount = Keyword.Values.empty() ? 2 : static_cast<u32>(Keyword.Values.size());
+
+            u32 Bits = 0;
+            while ((1ull << Bits) < ValueCount)
+                Bits++;
+
+            Layouts.push_back({ Keyword, Shift, Bits });
+            Shift += Bits;
+
+            Signature = HashString(Keyword.Name.c_str(), Signature);
+            for (const std::string& Value : Keyword.Values)
+                Signature = HashString(Value.c_str(), HashBytes("\0", 1, Signature));
+        }
+
+        assert(Shift <= 64 && "Too many keywords for a 64 bit variant key");
+        UsedBits = Shift >= 64 ? ~0ull : (1ull << Shift) - 1;
+    }
+
+    u32 ShaderVariantSet::FindKeyword(const char* Name) const
+    {
+        for (u32 i = 0; i < Layouts.size(); i++)
+        {
+            if (Layouts[i].Keyword.Name == Name)
+                return i;
+        }
+
+        assert(false && "Unknown shader keyword");
+        return 0;
+    }
+
+    u32 ShaderVariantSet::FindKeywordValue(u32 Keyword, const char* Value) const
+    {
+        const std::vector<std::string>& Values = Layouts[Keyword].Keyword.Values;
+
+        for (u32 i = 0; i < Values.size(); i++)
+        {
+            if (Values[i] == Value)
+                return i;
+        }
+
+        assert(false && "Unknown shader keyword value");
+        return 0;
+    }
+
+    u64 ShaderVariantSet::SetKeyword(u64 Key, u32 Keyword, u32 Value) const
+    {
+        const KeywordLayout& Layout = Layouts[Keyword];
+        u64 Mask = ((1ull << Layout.Bits) - 1) << Layout.Shift;
+
+        return (Key & ~Mask) | ((static_cast<u64>(Value) << Layout.Shift) & Mask);
+    }
+
+    ShaderProgram* ShaderVariantSet::Get(u64 Key)
+    {
+        assert((Key & ~UsedBits) == 0);
+
+        Variant& Current = Variants[Key];
+
+        if (!Current.Requested)
+        {
+            Current.Requested = true;
+            RequestedKeys.push_back(Key);
+        }
+
+        if (Current.Program)
+            return Current.Program.get();
+
+        if (Current.Failed)
+            return nullptr;
+
+        if (Current.Pending)
+        {
+            if (!Current.Pending->IsDone())
+                Current.Queue->Wait(Current.Pending);
+
+            //a handle that still isn't done says nothing about the variant, compile it here instead
+            if (Current.Pending->IsDone())
+            {
+                Current.Program = Current.Pending->Release();
+                Current.Failed = Current.Program == nullptr;
+                Current.Pending.reset();
+                Current.Queue = nullptr;
+
+                return Current.Program.get();
+            }
+
+            Current.Pending.reset();
+            Current.Queue = nullptr;
+        }
+
+        ShaderProgramConfig Config;
+        if (!GetVariantConfig(Key, Config))
+        {
+            Current.Failed = true;
+            return nullptr;
+        }
+
+        Current.Program = ShaderProgram::TryCreate(Config);
+        Current.Failed = Current.Program == nullptr;
+
+        return Current.Program.get();
+    }
+
+    ShaderProgram* ShaderVariantSet::TryGet(u64 Key) const
+    {
+        auto Iterator = Variants.find(Key);
+        if (Iterator == Variants.end())
+            return nullptr;
+
+        const Variant& Current = Iterator->second;
+
+        if (Current.Program)
+            return Current.Program.get();
+
+        if (Current.Pending)
+            return Current.Pending->Get();
+
+        return nullptr;
+    }
+
+    void ShaderVariantSet::Prewarm(ShaderCompileQueue& Queue, const std::vector<u64>& Keys)
+    {
+        for (u64 Key : Keys)
+        {
+            if ((Key & ~UsedBits) != 0)
+                continue;
+
+            Variant& Current = Variants[Key];
+            if (Current.Program || Current.Pending || Current.Failed)
+                continue;
+
+            ShaderProgramConfig Config;
+            if (!GetVariantConfig(Key, Config))
+            {
+                Current.Failed = true;
+                continue;
+            }
+
+            Current.Pending = Queue.Submit(Config);
+            Current.Queue = &Queue;
+        }
+    }
+
+    const std::vector<u64>& ShaderVariantSet::GetRequestedKeys() const
+    {
+        return RequestedKeys;
+    }
+
+    bool ShaderVariantSet::SaveRequestedKeys(const char* Path) const
+    {
+        std::ofstream File(Path, std::ios::trunc);
+        if (!File)
+        {
+            Log::Warning<LogCategory::Shader>("Failed to write shader variant list {}", Path);
+            return false;
+        }
+
+        File << std::hex << Signature << "\n";
+        for (u64 Key : RequestedKeys)
+            File << Key << "\n";
+
+        return true;
+    }
+
+    std::vector<u64> ShaderVariantSet::LoadRequestedKeys(const char* Path) const
+    {
+        std::vector<u64> Keys;
+
+        std::ifstream File(Path);
+        if (!File)
+            return Keys;
+
+        u64 FileSignature = 0;
+        File >> std::hex >> FileSignature;
+
+        //keywords changed since the list was recorded, the keys no longer mean the same thing
+        if (FileSignature != Signature)
+            return Keys;
+
+        u64 Key = 0;
+        while (File >> Key)
+            Keys.push_back(Key);
+
+        return Keys;
+    }
+
+    u32 ShaderVariantSet::GetKeyword(u64 Key, u32 Keyword) const
+    {
+        const KeywordLayout& Layout = Layouts[Keyword];
+
+        return static_cast<u32>((Key >> Layout.Shift) & ((1ull << Layout.Bits) - 1));
+    }
+
+    bool ShaderVariantSet::GetVariantConfig(u64 Key, ShaderProgramConfig& Config)
+    {
+        std::vector<ShaderDefine> Defines;
+
+        for (u32 i = 0; i < Layouts.size(); i++)
+        {
+            const ShaderKeyword& Keyword = Layouts[i].Keyword;
+            u32 Value = GetKeyword(Key, i);
+
+            if (Keyword.Values.empty())
+            {
+                Defines.push_back({ Keyword.Name, Value ? "1" : "0" });
+                continue;
+            }
+
+            assert(Value < Keyword.Values.size());
+
+            for (u32 j = 0; j < Keyword.Values.size(); j++)
+                Defines.push_back({ Keyword.Name + "_" + Keyword.Values[j], j == Value ? "1" : "0" });
+        }
+
+        //the preprocessor owns the expanded sources, they live as long as its cache
+        const char* Stages[StageCount] = {};
+
+        for (u32 i = 0; i < StageCount; i++)
+        {
+            if (!HasStage[i])
+                continue;
+
+            const PreprocessedShader* Stage = Preprocessor.PreprocessSource(Sources[i].c_str(), Defines);
+            if (Stage == nullptr)
+                return false;
+
+            Stages[i] = Stage->Source.c_str();
+        }
+
+        Config.VertexSource = Stages[0];
+        Config.FragmentSource = Stages[1];
+        Config.GeometrySource = Stages[2];
+        Config.ComputeSource = Stages[3];
+        Config.Separable = Separable;
+        Config.CacheDirectory = CacheDirectory.empty() ? nullptr : CacheDirectory.c_str();
+
+        return true;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ShaderManager.h"
+#include "ShaderCompileQueue.h"
+#include "ShaderPreprocessor.h"
+
+namespace Base
+{
+    //a boolean keyword is injected as "#define NAME 0/1", an enum keyword as "#define NAME_VALUE 0/1"
+    //for every value so shaders can test both with a plain #if that the preprocessor resolves
+    struct ShaderKeyword
+    {
+        std::string Name;
+        std::vector<std::string> Values;
+    };
+
+    //every permutation of one ShaderProgramConfig over a set of keywords, a variant is identified by a
+    //bitmask holding each keyword's value and only compiled the first time it is asked for
+    class ShaderVariantSet
+    {
+    public:
+        ShaderVariantSet(const ShaderVariantSet&) = delete;
+        ShaderVariantSet& operator=(const ShaderVariantSet&) = delete;
+
+        ShaderVariantSet(ShaderPreprocessor& Preprocessor, const ShaderProgramConfig& Config, const std::vector<ShaderKeyword>& Keywords);
+        ~ShaderVariantSet() = default;
+
+        //resolve names once up front and build keys from the indices on the hot path
+        u32 FindKeyword(const char* Name) const;
+        u32 FindKeywordValue(u32 Keyword, const char* Value) const;
+        u64 SetKeyword(u64 Key, u32 Keyword, u32 Value) const;
+
+        //compiles the variant right away if it doesn't exist yet, or waits for it if it is being prewarmed
+        //null if it failed to compile
+        ShaderProgram* Get(u64 Key);
+
+        //never blocks, null while the variant isn't ready
+        ShaderProgram* TryGet(u64 Key) const;
+
+        //submits variants to the queue so they compile in the background before they are first drawn
+        void Prewarm(ShaderCompileQueue& Queue, const std::vector<u64>& Keys);
+
+        //every key passed to Get so far in first use order, save it to prewarm the same set next run
+        const std::vector<u64>& GetRequestedKeys() const;
+        bool SaveRequestedKeys(const char* Path) const;
+        std::vector<u64> LoadRequestedKeys(const char* Path) const;
+
+    private:
+        struct KeywordLayout
+        {
+            ShaderKeyword Keyword;
+            u32 Shift;
+            u32 Bits;
+        };
+
+        struct Variant
+        {
+            std::unique_ptr<ShaderProgram> Program;
+            std::shared_ptr<PendingShaderProgram> Pending;
+
+            //the queue Pending was submitted to, only touched while Pending isn't done
+            ShaderCompileQueue* Queue = nullptr;
+            bool Failed = false;
+
+            //passed to Get at least once, prewarming alone doesn't count
+            bool Requested = false;
+        };
+
+        ShaderPreprocessor& Preprocessor;
+
+        //vertex, fragment, geometry, compute
+        static constexpr u32 StageCount = 4;
+        std::string Sources[StageCount];
+        bool HasStage[StageCount] = {};
+        std::string CacheDirectory;
+        bool Separable = false;
+
+        std::vector<KeywordLayout> Layouts;
+        u64 UsedBits = 0;
+
+        //hash of the keyword names and values, stored with saved keys so stale lists are ignored
+        u64 Signature = 0;
+
+        std::unordered_map<u64, Variant> Variants;
+        std::vector<u64> RequestedKeys;
+
+        u32 GetKeyword(u64 Key, u32 Keyword) const;
+        bool GetVariantConfig(u64 Key, ShaderProgramConfig& Config);
+    };
+}
@@ -0,0 +1,249 @@
+#include "UniformBlock.h"
+#include "../Util/Hash.h"
+#include "../Debug/Log.h"
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+namespace Base
+{
+    static void StripSuffix(std::string& String, const char* Suffix)
+    {
+        std::size_t Length = std::strlen(Suffix);
+        if (String.size() >= Length && String.compare(String.size() - Length, Length, Suffix) == 0)
+            String.erase(String.size() - Length);
+    }
+
+    std::vector<UniformBlockLayout> ReflectUniformBlocks(GLuint Program)
+    {
+        std::vector<UniformBlockLayout> Blocks;
+
+        GLint BlockCount = 0;
+        GLint MaxBlockNameLength = 0;
+        GLint MaxUniformNameLength = 0;
+        glGetProgramiv(Program, GL_ACTIVE_UNIFORM_BLOCKS, &BlockCount);
+        glGetProgramiv(Program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &MaxBlockNameLength);
+        glGetProgramiv(Program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &MaxUniformNameLength);
+
+        std::vector<char> Name;
+        Name.resize(std::max(MaxBlockNameLength, MaxUniformNameLength) + 1);
+
+        for (GLint i = 0; i < BlockCount; i++)
+        {
+            UniformBlockLayout& Block = Blocks.emplace_back();
+            Block.Index = static_cast<GLuint>(i);
+
+            GLsizei NameLength = 0;
+            glGetActiveUniformBlockName(Program, Block.Index, static_cast<GLsizei>(Name.size()), &NameLength, Name.data());
+            Block.Name.assign(Name.data(), NameLength);
+            Block.NameHash = HashString(Block.Name.c_str());
+
+            glGetActiveUniformBlockiv(Program, Block.Index, GL_UNIFORM_BLOCK_DATA_SIZE, &Block.DataSize);
+            glGetActiveUniformBlockiv(Program, Block.Index, GL_UNIFORM_BLOCK_BINDING, &Block.Binding);
+
+            GLint MemberCount = 0;
+            glGetActiveUniformBlockiv(Program, Block.Index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &MemberCount);
+
+            if (MemberCount <= 0)
+                continue;
+
+            std::vector<GLint> Indices(MemberCount);
+            glGetActiveUniformBlockiv(Program, Block.Index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, Indices.data());
+
+            std::vector<GLuint> UnsignedIndices(Indices.begin(), Indices.end());
+            std::vector<GLint> Types(MemberCount), Offsets(MemberCount), Sizes(MemberCount), ArrayStrides(MemberCount), MatrixStrides(MemberCount), RowMajor(MemberCount);
+
+            glGetActiveUniformsiv(Program, MemberCount, UnsignedIndices.data(), GL_UNIFORM_TYPE, Types.data());
+            glGetActiveUniformsiv(Program, MemberCount, UnsignedIndices.data(), GL_UNIFORM_OFFSET, Offsets.data());
+            glGetActiveUniformsiv(Program, MemberCount, UnsignedIndices.data(), GL_UNIFORM_SIZE, Sizes.data());
+            glGetActiveUniformsiv(Program, MemberCount, UnsignedIndices.data(), GL_UNIFORM_ARRAY_STRIDE, ArrayStrides.data());
+            glGetActiveUniformsiv(Program, MemberCount, UnsignedIndices.data(), GL_UNIFORM_MATRIX_STRIDE, MatrixStrides.data());
+            glGetActiveUniformsiv(Program, MemberCount, UnsignedIndices.data(), GL_UNIFORM_IS_ROW_MAJOR, RowMajor.data());
+
+            for (GLint j = 0; j < MemberCount; j++)
+            {
+                UniformBlockMember Member;
+
+                glGetActiveUniformName(Program, UnsignedIndices[j], static_cast<GLsizei>(Name.size()), &NameLength, Name.data());
+                Member.Name.assign(Name.data(), NameLength);
+
+                //named instances report "BlockName.Member", arrays "Member[0]", keep just "Member"
+                std::string Prefix = Block.Name + ".";
+                if (Member.Name.compare(0, Prefix.size(), Prefix) == 0)
+                    Member.Name.erase(0, Prefix.size());
+
+                StripSuffix(Member.Name, "[0]");
+
+                Member.Type = static_cast<GLenum>(Types[j]);
+                Member.Offset = Offsets[j];
+                Member.ArraySize = Sizes[j];
+                Member.ArrayStride = ArrayStrides[j];
+                Member.MatrixStride = MatrixStrides[j];
+                Member.RowMajor = RowMajor[j] != 0;
+
+                Block.Members.push_back(std::move(Member));
+            }
+
+            std::sort(Block.Members.begin(), Block.Members.end(),
+                [](const UniformBlockMember& a, const UniformBlockMember& b) { return a.Offset < b.Offset; });
+        }
+
+        return Blocks;
+    }
+
+    struct Std140Type
+    {
+        const char* Name;
+        GLint Size;
+    };
+
+    //C++ type of a single std140 element, matrices with less than 4 rows come out padded
+    static Std140Type GetStd140Type(GLenum Type)
+    {
+        switch (Type)
+        {
+            case(GL_FLOAT): return { "f32", 4 };
+            case(GL_FLOAT_VEC2): return { "glm::vec2", 8 };
+            case(GL_FLOAT_VEC3): return { "glm::vec3", 12 };
+            case(GL_FLOAT_VEC4): return { "glm::vec4", 16 };
+            case(GL_INT): return { "i32", 4 };
+            case(GL_INT_VEC2): return { "glm::ivec2", 8 };
+            case(GL_INT_VEC3): return { "glm::ivec3", 12 };
+            case(GL_INT_VEC4): return { "glm::ivec4", 16 };
+            case(GL_UNSIGNED_INT): return { "u32", 4 };
+            case(GL_UNSIGNED_INT_VEC2): return { "glm::uvec2", 8 };
+            case(GL_UNSIGNED_INT_VEC3): return { "glm::uvec3", 12 };
+            case(GL_UNSIGNED_INT_VEC4): return { "glm::uvec4", 16 };
+            case(GL_BOOL): return { "Std140::Bool", 4 };
+            case(GL_BOOL_VEC2): return { "glm::uvec2", 8 };
+            case(GL_BOOL_VEC3): return { "glm::uvec3", 12 };
+            case(GL_BOOL_VEC4): return { "glm::uvec4", 16 };
+            case(GL_FLOAT_MAT2): return { "Std140::Mat2", 32 };
+            case(GL_FLOAT_MAT3): return { "Std140::Mat3", 48 };
+            case(GL_FLOAT_MAT4): return { "glm::mat4", 64 };
+            case(GL_FLOAT_MAT2x3): return { "Std140::Mat2x3", 32 };
+            case(GL_FLOAT_MAT2x4): return { "glm::mat2x4", 32 };
+            case(GL_FLOAT_MAT3x2): return { "Std140::Mat3x2", 48 };
+            case(GL_FLOAT_MAT3x4): return { "glm::mat3x4", 48 };
+            case(GL_FLOAT_MAT4x2): return { "Std140::Mat4x2", 64 };
+            case(GL_FLOAT_MAT4x3): return { "Std140::Mat4x3", 64 };
+        }
+
+        return { nullptr, 0 };
+    }
+
+    static std::string GetIdentifier(const std::string& Name)
+    {
+        std::string Identifier;
+
+        for (char Character : Name)
+        {
+            bool Valid = std::isalnum(static_cast<unsigned char>(Character)) || Character == '_';
+
+            if (Valid)
+                Identifier += Character;
+            else if (!Identifier.empty() && Identifier.back() != '_')
+                Identifier += '_';
+        }
+
+        while (!Identifier.empty() && Identifier.back() == '_')
+            Identifier.pop_back();
+
+        return Identifier;
+    }
+
+    std::string GenerateStd140Struct(const UniformBlockLayout& Layout, const char* StructName)
+    {
+        std::string Members;
+        std::string Checks;
+
+        GLint Offset = 0;
+        u32 PaddingCount = 0;
+
+        auto AddPadding = [&](GLint Size)
+        {
+            if (Size > 0)
+                Members += "        u8 Padding" + std::to_string(PaddingCount++) + "[" + std::to_string(Size) + "];\n";
+        };
+
+        for (const UniformBlockMember& Member : Layout.Members)
+        {
+            //overlapping members only happen with unsized arrays, nothing sensible to emit for those
+            if (Member.Offset < Offset)
+                continue;
+
+            AddPadding(Member.Offset - Offset);
+            Offset = Member.Offset;
+
+            std::string Identifier = GetIdentifier(Member.Name);
+            Std140Type Type = GetStd140Type(Member.Type);
+
+            bool IsArray = Member.ArrayStride > 0;
+            GLint Size = IsArray ? Member.ArrayStride * Member.ArraySize : Type.Size;
+
+            if (Type.Name == nullptr || Member.RowMajor)
+            {
+                //no direct C++ equivalent, reserve the bytes and leave it to whoever fills the struct
+                Members += "        u8 " + Identifier + "[" + std::to_string(Size) + "]; //" + (Member.RowMajor ? "row_major" : "unsupported type") + "\n";
+            }
+            else if (!IsArray)
+            {
+                Members += std::string("        ") + Type.Name + " " + Identifier + ";\n";
+            }
+            else if (Member.ArrayStride == Type.Size)
+            {
+                Members += std::string("        ") + Type.Name + " " + Identifier + "[" + std::to_string(Member.ArraySize) + "];\n";
+            }
+            else
+            {
+                //std140 only ever pads array elements up to 16 bytes
+                Members += std::string("        Std140::Array<") + Type.Name + ", " + std::to_string(Member.ArraySize) + "> " + Identifier + ";\n";
+                Size = ((Type.Size + 15) / 16) * 16 * Member.ArraySize;
+            }
+
+            Checks += std::string("    STD140_ASSERT_OFFSET(") + StructName + ", " + Identifier + ", " + std::to_string(Member.Offset) + ");\n";
+            Offset += Size;
+        }
+
+        AddPadding(Layout.DataSize - Offset);
+
+        std::string Result;
+        Result += "    //generated from uniform block " + Layout.Name + "\n";
+        Result += std::string("    struct ") + StructName + "\n    {\n";
+        Result += Members;
+        Result += "    };\n\n";
+        Result += Checks;
+        Result += std::string("    STD140_ASSERT_SIZE(") + StructName + ", " + std::to_string(Layout.DataSize) + ");\n";
+
+        return Result;
+    }
+
+    bool ValidateUniformBlockLayout(const UniformBlockLayout& Layout, std::size_t StructSize, std::initializer_list<Std140MemberOffset> Members)
+    {
+        bool Valid = true;
+
+        if (StructSize < static_cast<std::size_t>(Layout.DataSize))
+        {
+            Log::Error<LogCategory::Shader>("Uniform block {} is {} bytes but its struct is only {}", Layout.Name, Layout.DataSize, StructSize);
+            Valid = false;
+        }
+
+        for (const Std140MemberOffset& Expected : Members)
+        {
+            auto Iterator = std::find_if(Layout.Members.begin(), Layout.Members.end(),
+                [&](const UniformBlockMember& Member) { return Member.Name == Expected.Name; });
+
+            //the compiler is free to drop members the shader never reads
+            if (Iterator == Layout.Members.end())
+                continue;
+
+            if (static_cast<std::size_t>(Iterator->Offset) != Expected.Offset)
+            {
+                Log::Error<LogCategory::Shader>("Uniform block {} has {} at offset {} but its struct has it at {}", Layout.Name, Expected.Name, Iterator->Offset, Expected.Offset);
+                Valid = false;
+            }
+        }
+
+        return Valid;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+namespace Base
+{
+    struct UniformBlockMember
+    {
+        std::string Name;
+        GLenum Type = 0;
+        GLint Offset = 0;
+        GLint ArraySize = 1;
+        GLint ArrayStride = 0;
+        GLint MatrixStride = 0;
+        bool RowMajor = false;
+    };
+
+    struct UniformBlockLayout
+    {
+        std::string Name;
+        u64 NameHash = 0;
+        GLuint Index = 0;
+        GLint DataSize = 0;
+        GLint Binding = 0;
+
+        //sorted by offset
+        std::vector<UniformBlockMember> Members;
+    };
+
+    std::vector<UniformBlockLayout> ReflectUniformBlocks(GLuint Program);
+
+    //writes a C++ struct matching the block with explicit padding plus a static_assert for every
+    //member offset and the total size, meant for generating headers from a linked program
+    std::string GenerateStd140Struct(const UniformBlockLayout& Layout, const char* StructName);
+
+    struct Std140MemberOffset
+    {
+        const char* Name;
+        std::size_t Offset;
+    };
+
+    #define STD140_MEMBER(Struct, Member) ::Base::Std140MemberOffset{ #Member, offsetof(Struct, Member) }
+
+    //runtime counterpart of the generated static_asserts, compares a hand written struct against the
+    //offsets the driver reports and logs every member that doesn't line up
+    bool ValidateUniformBlockLayout(const UniformBlockLayout& Layout, std::size_t StructSize, std::initializer_list<Std140MemberOffset> Members);
+}
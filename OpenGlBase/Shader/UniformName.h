@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+
+#include "../Util/Hash.h"
+
+namespace Base
+{
+    //a uniform name with its hash computed at compile time, string literals convert implicitly
+    //so SetUniform("ModelMatrix", Value) does no hashing or string work at runtime
+    struct UniformName
+    {
+        const char* Name;
+        u64 Hash;
+
+        template<std::size_t Length>
+        consteval UniformName(const char (&Literal)[Length])
+            : Name(Literal), Hash(HashString(Literal))
+        {
+        }
+
+        //for names only known at runtime, hashes on every call so keep it off the hot path
+        static constexpr UniformName FromString(const char* String)
+        {
+            return UniformName(String, HashString(String));
+        }
+
+    private:
+        constexpr UniformName(const char* String, u64 StringHash)
+            : Name(String), Hash(StringHash)
+        {
+        }
+    };
+}
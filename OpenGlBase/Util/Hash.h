@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+
+namespace Base
+{
+    //64 bit FNV-1a, constexpr so names can also be hashed at compile time
+    constexpr u64 HashOffsetBasis = 14695981039346656037ull;
+    constexpr u64 HashPrime = 1099511628211ull;
+
+    constexpr u64 HashString(const char* String, u64 Hash = HashOffsetBasis)
+    {
+        while (*String)
+        {
+            Hash ^= static_cast<u8>(*String++);
+            Hash *= HashPrime;
+        }
+        return Hash;
+    }
+
+    inline u64 HashBytes(const void* Data, std::size_t Size, u64 Hash = HashOffsetBasis)
+    {
+        const u8* Bytes = static_cast<const u8*>(Data);
+        for (std::size_t i = 0; i < Size; i++)
+        {
+            Hash ^= Bytes[i];
+            Hash *= HashPrime;
+        }
+        return Hash;
+    }
+}
@@ -0,0 +1,104 @@
+#include "FramePacer.h"
+#include "../Debug/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace Base
+{
+    static f64 ToSeconds(std::chrono::steady_clock::duration Duration)
+    {
+        return std::chrono::duration<f64>(Duration).count();
+    }
+
+    void FramePacer::SetMode(FramePacingMode NewMode, f64 NewTargetFrameRate)
+    {
+        Mode = NewMode;
+        if (NewTargetFrameRate > 0.0)
+            TargetFrameRate = NewTargetFrameRate;
+
+        Deadline = Clock::now();
+    }
+
+    FramePacingMode FramePacer::GetMode() const
+    {
+        return Mode;
+    }
+
+    f64 FramePacer::GetTargetFrameRate() const
+    {
+        return TargetFrameRate;
+    }
+
+    i32 FramePacer::GetSwapInterval(bool TearControlSupported) const
+    {
+        switch (Mode)
+        {
+            case(FramePacingMode::Uncapped):
+            case(FramePacingMode::FixedRate): return 0;
+            case(FramePacingMode::VSync): return 1;
+            case(FramePacingMode::AdaptiveVSync): return TearControlSupported ? -1 : 1;
+        }
+
+        return 0;
+    }
+
+    void FramePacer::SleepUntil(Clock::time_point Target)
+    {
+        //sleeps are only accurate to the scheduler tick, 1ms at best and 15.6ms on a default windows timer.
+        //so it sleeps in 1ms steps while more than a pessimistic guess of one step is left and spins the
+        //rest, the guess is learned from the steps themselves
+        while (true)
+        {
+            Clock::time_point Now = Clock::now();
+            f64 Remaining = ToSeconds(Target - Now);
+            if (Remaining <= SleepMean + 2.0 * std::sqrt(SleepVariance))
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            f64 Observed = ToSeconds(Clock::now() - Now);
+            f64 Delta = Observed - SleepMean;
+            SleepMean += Delta * 0.05;
+            SleepVariance = (SleepVariance + Delta * Delta * 0.05) * 0.95;
+        }
+
+        while (Clock::now() < Target)
+            std::this_thread::yield();
+    }
+
+    void FramePacer::Wait()
+    {
+        WaitStart = Clock::now();
+        Times.Work = ToSeconds(WaitStart - FrameStart);
+
+        if (Mode != FramePacingMode::FixedRate)
+            return;
+
+        PROFILE_SCOPE("FramePacer::Wait");
+
+        //deadlines step by exactly one period so the rate doesn't drift with the wake up error, after a
+        //hitch longer than a frame it starts over instead of rushing frames out to catch up
+        Clock::duration Period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(1.0 / TargetFrameRate));
+        Deadline += Period;
+        if (Deadline < WaitStart - Period)
+            Deadline = WaitStart;
+
+        SleepUntil(Deadline);
+    }
+
+    void FramePacer::EndFrame()
+    {
+        FrameStart = Clock::now();
+        Times.Wait = ToSeconds(FrameStart - WaitStart);
+
+        f64 Blend = std::min(Times.Work + Times.Wait, 1.0);
+        Times.AverageWork += (Times.Work - Times.AverageWork) * Blend;
+        Times.AverageWait += (Times.Wait - Times.AverageWait) * Blend;
+    }
+
+    const FramePacingTimes& FramePacer::GetTimes() const
+    {
+        return Times;
+    }
+}
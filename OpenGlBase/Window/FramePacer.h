@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+
+namespace Base
+{
+    enum class FramePacingMode : u8
+    {
+        //swap interval 0, as fast as the frame can be made
+        Uncapped,
+
+        //swap interval 0 and the pacer waits out the rest of each 1 / TargetFrameRate
+        FixedRate,
+
+        //swap interval 1
+        VSync,
+
+        //swap interval -1, waits for vblank but a frame that missed it is shown straight away and tears
+        //instead of waiting another whole refresh. plain vsync where the driver can't do it
+        AdaptiveVSync
+    };
+
+    //both in seconds, work is from the end of the last frame's wait to the start of this one's, wait is the
+    //pacer's sleep plus however long the swap blocked. averages are exponential over roughly the last second
+    struct FramePacingTimes
+    {
+        f64 Work = 0.0;
+        f64 Wait = 0.0;
+        f64 AverageWork = 0.0;
+        f64 AverageWait = 0.0;
+    };
+
+    class FramePacer
+    {
+    public:
+        void SetMode(FramePacingMode NewMode, f64 NewTargetFrameRate);
+        FramePacingMode GetMode() const;
+        f64 GetTargetFrameRate() const;
+
+        //what glfwSwapInterval should be set to for the mode
+        i32 GetSwapInterval(bool TearControlSupported) const;
+
+        //right before the swap, sleeps in FixedRate
+        void Wait();
+
+        //right after the swap
+        void EndFrame();
+
+        const FramePacingTimes& GetTimes() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        FramePacingMode Mode = FramePacingMode::Uncapped;
+        f64 TargetFrameRate = 60.0;
+
+        Clock::time_point FrameStart = Clock::now();
+        Clock::time_point WaitStart = FrameStart;
+        Clock::time_point Deadline = FrameStart;
+
+        //how long a 1ms sleep actually takes on this machine, exponential mean and variance
+        f64 SleepMean = 0.0015;
+        f64 SleepVariance = 0.0;
+
+        FramePacingTimes Times;
+
+        void SleepUntil(Clock::time_point Target);
+    };
+}
@@ -0,0 +1,235 @@
+#include "FrameStats.h"
+#include "../Debug/Log.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace Base
+{
+    static constexpr u64 MaxMicroseconds = (u64(1) << (FrameTimeHistogram::MaxShift + FrameTimeHistogram::SubBucketBits)) - 1;
+
+    static bool WriteFile(const std::string& Path, const std::string& Data)
+    {
+        std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+        if (!File || !File.write(Data.data(), Data.size()))
+        {
+            Log::Error<LogCategory::Window>("Failed to write frame stats {}", Path);
+            return false;
+        }
+
+        return true;
+    }
+
+    void FrameTimeHistogram::Record(f64 Milliseconds)
+    {
+        u64 Microseconds = std::min(static_cast<u64>(std::max(Milliseconds, 0.0) * 1000.0), MaxMicroseconds);
+
+        u32 Bucket = static_cast<u32>(Microseconds);
+        if (Microseconds >= SubBucketCount)
+        {
+            //the top SubBucketBits bits pick the bucket inside the value's power of two
+            u32 Shift = static_cast<u32>(std::bit_width(Microseconds)) - SubBucketBits;
+            u32 Top = static_cast<u32>(Microseconds >> Shift);
+            Bucket = SubBucketCount + (Shift - 1) * SubBucketHalf + (Top - SubBucketHalf);
+        }
+
+        Counts[Bucket]++;
+        Count++;
+    }
+
+    void FrameTimeHistogram::Reset()
+    {
+        Counts.fill(0);
+        Count = 0;
+    }
+
+    u64 FrameTimeHistogram::GetCount() const
+    {
+        return Count;
+    }
+
+    f64 FrameTimeHistogram::GetValueAtPercentile(f64 Percentile) const
+    {
+        if (Count == 0)
+            return 0.0;
+
+        u64 Target = std::max<u64>(static_cast<u64>(std::ceil(std::clamp(Percentile, 0.0, 100.0) / 100.0 * static_cast<f64>(Count))), 1);
+
+        u64 Cumulative = 0;
+        for (u32 i = 0; i < BucketCount; i++)
+        {
+            Cumulative += Counts[i];
+            if (Cumulative >= Target)
+                return GetBucketUpper(i);
+        }
+
+        return GetBucketUpper(BucketCount - 1);
+    }
+
+    f64 FrameTimeHistogram::GetBucketLower(u32 Bucket)
+    {
+        if (Bucket < SubBucketCount)
+            return static_cast<f64>(Bucket) / 1000.0;
+
+        u32 Shift = (Bucket - SubBucketCount) / SubBucketHalf + 1;
+        u64 Top = (Bucket - SubBucketCount) % SubBucketHalf + SubBucketHalf;
+        return static_cast<f64>(Top << Shift) / 1000.0;
+    }
+
+    f64 FrameTimeHistogram::GetBucketUpper(u32 Bucket)
+    {
+        if (Bucket < SubBucketCount)
+            return static_cast<f64>(Bucket + 1) / 1000.0;
+
+        u32 Shift = (Bucket - SubBucketCount) / SubBucketHalf + 1;
+        u64 Top = (Bucket - SubBucketCount) % SubBucketHalf + SubBucketHalf;
+        return static_cast<f64>((Top + 1) << Shift) / 1000.0;
+    }
+
+    u64 FrameTimeHistogram::GetBucketCount(u32 Bucket) const
+    {
+        return Counts[Bucket];
+    }
+
+    bool FrameTimeHistogram::SaveCsv(const std::string& Path) const
+    {
+        std::string Output = "lower_ms,upper_ms,count,cumulative_percent\n";
+
+        u64 Cumulative = 0;
+        char Buffer[96];
+        for (u32 i = 0; i < BucketCount; i++)
+        {
+            if (Counts[i] == 0)
+                continue;
+
+            Cumulative += Counts[i];
+            std::snprintf(Buffer, sizeof(Buffer), "%.3f,%.3f,%llu,%.4f\n", GetBucketLower(i), GetBucketUpper(i),
+                static_cast<unsigned long long>(Counts[i]), static_cast<f64>(Cumulative) * 100.0 / static_cast<f64>(Count));
+            Output += Buffer;
+        }
+
+        return WriteFile(Path, Output);
+    }
+
+    FrameStats::FrameStats(u32 HistorySize, f64 StutterFactor)
+        : Samples(std::max(HistorySize, 1u))
+        , StutterFactor(StutterFactor)
+    {
+    }
+
+    void FrameStats::AddFrame(f64 Seconds)
+    {
+        f64 Milliseconds = Seconds * 1000.0;
+
+        //a few frames first so the average means something, loading hitches aren't stutters
+        bool Stutter = TotalFrames >= 8 && Milliseconds > AverageMilliseconds * StutterFactor;
+
+        //exponential so it follows changes in load over a second or so
+        AverageMilliseconds = TotalFrames == 0 ? Milliseconds : AverageMilliseconds + (Milliseconds - AverageMilliseconds) * 0.05;
+
+        Sample& Slot = Samples[Next];
+        if (Count == Samples.size())
+            Stutters -= Slot.Stutter;
+        else
+            Count++;
+
+        Slot = { static_cast<f32>(Milliseconds), Stutter };
+        Next = (Next + 1) % static_cast<u32>(Samples.size());
+
+        Stutters += Stutter;
+        TotalStutters += Stutter;
+        TotalFrames++;
+
+        Histogram.Record(Milliseconds);
+    }
+
+    void FrameStats::Reset()
+    {
+        Next = 0;
+        Count = 0;
+        TotalFrames = 0;
+        TotalStutters = 0;
+        Stutters = 0;
+        AverageMilliseconds = 0.0;
+        Histogram.Reset();
+    }
+
+    u32 FrameStats::GetFrameCount() const
+    {
+        return Count;
+    }
+
+    u64 FrameStats::GetTotalFrames() const
+    {
+        return TotalFrames;
+    }
+
+    FrameTimePercentiles FrameStats::GetPercentiles() const
+    {
+        FrameTimePercentiles Result;
+        if (Count == 0)
+            return Result;
+
+        Sorted.clear();
+        f64 Sum = 0.0;
+        for (u32 i = 0; i < Count; i++)
+        {
+            Sorted.push_back(Samples[i].Milliseconds);
+            Sum += Samples[i].Milliseconds;
+        }
+
+        std::sort(Sorted.begin(), Sorted.end());
+
+        //nearest rank, so p99.9 of fewer than 1000 frames is the worst one
+        auto AtPercentile = [&](f64 Percentile)
+        {
+            std::size_t Rank = static_cast<std::size_t>(std::ceil(Percentile / 100.0 * static_cast<f64>(Count)));
+            return static_cast<f64>(Sorted[std::clamp<std::size_t>(Rank, 1, Count) - 1]);
+        };
+
+        Result.P50 = AtPercentile(50.0);
+        Result.P95 = AtPercentile(95.0);
+        Result.P99 = AtPercentile(99.0);
+        Result.P999 = AtPercentile(99.9);
+        Result.Mean = Sum / Count;
+        Result.Max = Sorted.back();
+        Result.Frames = Count;
+        return Result;
+    }
+
+    u32 FrameStats::GetStutterCount() const
+    {
+        return Stutters;
+    }
+
+    u64 FrameStats::GetTotalStutters() const
+    {
+        return TotalStutters;
+    }
+
+    const FrameTimeHistogram& FrameStats::GetHistogram() const
+    {
+        return Histogram;
+    }
+
+    bool FrameStats::SaveCsv(const std::string& Path) const
+    {
+        std::string Output = "frame,time_ms,stutter\n";
+
+        u32 Capacity = static_cast<u32>(Samples.size());
+        u32 Oldest = Count == Capacity ? Next : 0;
+        u64 FirstFrame = TotalFrames - Count;
+
+        char Buffer[64];
+        for (u32 i = 0; i < Count; i++)
+        {
+            const Sample& Frame = Samples[(Oldest + i) % Capacity];
+            std::snprintf(Buffer, sizeof(Buffer), "%llu,%.4f,%d\n", static_cast<unsigned long long>(FirstFrame + i), Frame.Milliseconds, Frame.Stutter ? 1 : 0);
+            Output += Buffer;
+        }
+
+        return WriteFile(Path, Output);
+    }
+}
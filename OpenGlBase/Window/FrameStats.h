@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+
+namespace Base
+{
+    //all in milliseconds
+    struct FrameTimePercentiles
+    {
+        f64 P50 = 0.0;
+        f64 P95 = 0.0;
+        f64 P99 = 0.0;
+        f64 P999 = 0.0;
+        f64 Mean = 0.0;
+        f64 Max = 0.0;
+        u32 Frames = 0;
+    };
+
+    //log linear buckets like HdrHistogram, every power of two is split into 32 buckets so any value
+    //is within about 3% of its bucket's bounds, from 1 microsecond up to a bit over two minutes. fixed
+    //size, recording is an index and an increment
+    class FrameTimeHistogram
+    {
+    public:
+        static constexpr u32 SubBucketBits = 6;
+        static constexpr u32 SubBucketCount = 1 << SubBucketBits;
+        static constexpr u32 SubBucketHalf = SubBucketCount / 2;
+        static constexpr u32 MaxShift = 21;
+        static constexpr u32 BucketCount = SubBucketCount + MaxShift * SubBucketHalf;
+
+        void Record(f64 Milliseconds);
+        void Reset();
+
+        u64 GetCount() const;
+
+        //upper bound of the bucket the percentile falls in, Percentile is 0 to 100
+        f64 GetValueAtPercentile(f64 Percentile) const;
+
+        //bounds of a bucket in milliseconds
+        static f64 GetBucketLower(u32 Bucket);
+        static f64 GetBucketUpper(u32 Bucket);
+        u64 GetBucketCount(u32 Bucket) const;
+
+        //lower_ms,upper_ms,count,cumulative_percent for every bucket that has a frame in it
+        bool SaveCsv(const std::string& Path) const;
+
+    private:
+        std::array<u64, BucketCount> Counts = {};
+        u64 Count = 0;
+    };
+
+    //rolling window of the last frame times for percentiles and a histogram of every frame since
+    //the last Reset. a stutter is a frame that took StutterFactor times longer than the average of
+    //the frames before it
+    class FrameStats
+    {
+    public:
+        explicit FrameStats(u32 HistorySize = 1024, f64 StutterFactor = 2.0);
+
+        void AddFrame(f64 Seconds);
+        void Reset();
+
+        //frames in the rolling window and since the last Reset
+        u32 GetFrameCount() const;
+        u64 GetTotalFrames() const;
+
+        //sorts a copy of the rolling window, fine once a frame for a HUD but not per draw
+        FrameTimePercentiles GetPercentiles() const;
+
+        u32 GetStutterCount() const;
+        u64 GetTotalStutters() const;
+
+        const FrameTimeHistogram& GetHistogram() const;
+
+        //frame,time_ms,stutter for the rolling window, oldest first
+        bool SaveCsv(const std::string& Path) const;
+
+    private:
+        struct Sample
+        {
+            f32 Milliseconds;
+            bool Stutter;
+        };
+
+        std::vector<Sample> Samples;
+        u32 Next = 0;
+        u32 Count = 0;
+
+        u64 TotalFrames = 0;
+        u64 TotalStutters = 0;
+        u32 Stutters = 0;
+
+        f64 StutterFactor;
+        f64 AverageMilliseconds = 0.0;
+
+        FrameTimeHistogram Histogram;
+
+        mutable std::vector<f32> Sorted;
+    };
+}
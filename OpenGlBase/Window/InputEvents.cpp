@@ -0,0 +1,43 @@
+#include "InputEvents.h"
+#include <bit>
+
+namespace Base
+{
+    InputEventQueue::InputEventQueue(u32 Capacity)
+    {
+        u64 Size = std::bit_ceil(static_cast<u64>(Capacity < 2 ? 2 : Capacity));
+        Events = std::make_unique<InputEvent[]>(Size);
+        Mask = Size - 1;
+    }
+
+    bool InputEventQueue::Push(const InputEvent& Event)
+    {
+        u64 CurrentHead = Head.load(std::memory_order_relaxed);
+        if (CurrentHead - Tail.load(std::memory_order_acquire) > Mask)
+        {
+            Dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Events[CurrentHead & Mask] = Event;
+        Head.store(CurrentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    u32 InputEventQueue::Drain(std::vector<InputEvent>& Output)
+    {
+        u64 CurrentTail = Tail.load(std::memory_order_relaxed);
+        u64 CurrentHead = Head.load(std::memory_order_acquire);
+
+        for (u64 i = CurrentTail; i != CurrentHead; i++)
+            Output.push_back(Events[i & Mask]);
+
+        Tail.store(CurrentHead, std::memory_order_release);
+        return static_cast<u32>(CurrentHead - CurrentTail);
+    }
+
+    u32 InputEventQueue::TakeDropped()
+    {
+        return Dropped.exchange(0, std::memory_order_relaxed);
+    }
+}
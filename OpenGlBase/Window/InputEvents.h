@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Base
+{
+    enum class InputEventType : u8
+    {
+        Key,
+        MouseButton,
+        CursorPosition,
+        Scroll,
+
+        //the window callbacks only keep their latest event outside the queue, so they can't be dropped,
+        //Tick merges them into the frame's events by time
+        WindowSize,
+        FrameBufferSize,
+        WindowPosition
+    };
+
+    enum class InputAction : u8
+    {
+        Release,
+        Press,
+        Repeat
+    };
+
+    //one GLFW input callback. Code is a KeyCodes or MouseButtonCodes, Value the cursor position, the
+    //scroll offsets or the new size or position, Time is glfwGetTime when the callback ran
+    struct InputEvent
+    {
+        f64 Time = 0.0;
+        dvec2 Value = { 0.0, 0.0 };
+        InputEventType Type = InputEventType::Key;
+        InputAction Action = InputAction::Press;
+        u16 Code = 0;
+        i32 Mods = 0;
+    };
+
+    //fixed capacity ring, one thread pushes and one drains without locks. events that don't fit are
+    //dropped and counted, the oldest ones already queued are never overwritten
+    class InputEventQueue
+    {
+    public:
+        //rounded up to a power of two
+        explicit InputEventQueue(u32 Capacity = 1024);
+
+        bool Push(const InputEvent& Event);
+
+        //appends everything pushed so far in the order it was pushed
+        u32 Drain(std::vector<InputEvent>& Output);
+
+        //events dropped since the last call
+        u32 TakeDropped();
+
+    private:
+        std::unique_ptr<InputEvent[]> Events;
+        u64 Mask;
+
+        alignas(64) std::atomic<u64> Head = 0;
+        alignas(64) std::atomic<u64> Tail = 0;
+        std::atomic<u32> Dropped = 0;
+    };
+}
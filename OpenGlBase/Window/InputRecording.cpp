@@ -0,0 +1,191 @@
+#include "InputRecording.h"
+#include "../Debug/Log.h"
+#include "../Debug/LogFormat.h"
+#include <cstring>
+#include <iterator>
+
+namespace Base
+{
+    static bool HasValue(InputEventType Type)
+    {
+        return Type != InputEventType::Key && Type != InputEventType::MouseButton;
+    }
+
+    template<typename T>
+    static void WriteRaw(std::string& Output, const T& Value)
+    {
+        Output.append(reinterpret_cast<const char*>(&Value), sizeof(T));
+    }
+
+    template<typename T>
+    static bool ReadRaw(std::string_view Data, std::size_t& Offset, T& Value)
+    {
+        if (sizeof(T) > Data.size() - Offset)
+            return false;
+
+        std::memcpy(&Value, Data.data() + Offset, sizeof(T));
+        Offset += sizeof(T);
+        return true;
+    }
+
+    bool InputRecorder::Open(const std::string& Path)
+    {
+        Close();
+
+        File.open(Path, std::ios::binary | std::ios::trunc);
+        if (!File)
+        {
+            Log::Error<LogCategory::Window>("Failed to open input recording {}", Path);
+            return false;
+        }
+
+        Buffer.clear();
+        WriteRaw(Buffer, InputRecordingMagic);
+        WriteRaw(Buffer, InputRecordingVersion);
+        File.write(Buffer.data(), Buffer.size());
+
+        FrameIndex = 0;
+        return true;
+    }
+
+    void InputRecorder::Close()
+    {
+        if (File.is_open())
+            File.close();
+    }
+
+    bool InputRecorder::IsOpen() const
+    {
+        return File.is_open();
+    }
+
+    void InputRecorder::WriteFrame(f64 DeltaTime, f64 FrameTime, const std::vector<InputEvent>& Events)
+    {
+        Buffer.clear();
+
+        Log::WriteVarint(Buffer, FrameIndex++);
+        WriteRaw(Buffer, DeltaTime);
+        Log::WriteVarint(Buffer, Events.size());
+
+        for (const InputEvent& Event : Events)
+        {
+            Buffer += static_cast<char>(Event.Type);
+            Buffer += static_cast<char>(Event.Action);
+            Log::WriteVarint(Buffer, Event.Code);
+            Log::WriteVarint(Buffer, (static_cast<u64>(static_cast<i64>(Event.Mods)) << 1) ^ static_cast<u64>(static_cast<i64>(Event.Mods) >> 63));
+            WriteRaw(Buffer, static_cast<f32>(Event.Time - FrameTime));
+
+            if (HasValue(Event.Type))
+            {
+                WriteRaw(Buffer, Event.Value.x);
+                WriteRaw(Buffer, Event.Value.y);
+            }
+        }
+
+        //flushed every frame so a crash still leaves every frame up to the last whole write readable
+        if (!File.write(Buffer.data(), Buffer.size()) || !File.flush())
+        {
+            Log::Error<LogCategory::Window>("Failed to write input recording, stopping it");
+            Close();
+        }
+    }
+
+    bool InputReplay::Open(const std::string& Path)
+    {
+        Close();
+
+        std::ifstream File(Path, std::ios::binary);
+        if (!File)
+        {
+            Log::Error<LogCategory::Window>("Failed to open input recording {}", Path);
+            return false;
+        }
+
+        Data.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+
+        u32 Magic = 0;
+        u32 Version = 0;
+        if (!ReadRaw(Data, Offset, Magic) || !ReadRaw(Data, Offset, Version) || Magic != InputRecordingMagic || Version != InputRecordingVersion)
+        {
+            Log::Error<LogCategory::Window>("{} isn't an input recording this version can read", Path);
+            Close();
+            return false;
+        }
+
+        Loaded = true;
+        return true;
+    }
+
+    void InputReplay::Close()
+    {
+        Data.clear();
+        Offset = 0;
+        FrameIndex = 0;
+        Loaded = false;
+    }
+
+    bool InputReplay::IsOpen() const
+    {
+        return Loaded;
+    }
+
+    bool InputReplay::ReadFrame(f64 FrameTime, f64& DeltaTime, std::vector<InputEvent>& Events)
+    {
+        if (!Loaded || Offset >= Data.size())
+            return false;
+
+        //parsed on the side, a damaged frame hands out nothing rather than the events before the damage
+        std::size_t Position = Offset;
+        f64 FrameDeltaTime = 0.0;
+        FrameEvents.clear();
+
+        u64 Index = 0;
+        u64 EventCount = 0;
+        if (!Log::ReadVarint(Data, Position, Index) || Index != FrameIndex || !ReadRaw(Data, Position, FrameDeltaTime) || !Log::ReadVarint(Data, Position, EventCount))
+        {
+            Log::Error<LogCategory::Window>("Input recording is damaged at frame {}", FrameIndex);
+            return false;
+        }
+
+        for (u64 i = 0; i < EventCount; i++)
+        {
+            InputEvent Event;
+            u8 Type = 0;
+            u8 Action = 0;
+            u64 Code = 0;
+            u64 Mods = 0;
+            f32 TimeOffset = 0.0f;
+
+            bool Success = ReadRaw(Data, Position, Type) && ReadRaw(Data, Position, Action) && Log::ReadVarint(Data, Position, Code)
+                && Log::ReadVarint(Data, Position, Mods) && ReadRaw(Data, Position, TimeOffset)
+                && Type <= static_cast<u8>(InputEventType::WindowPosition) && Action <= static_cast<u8>(InputAction::Repeat);
+
+            Event.Type = static_cast<InputEventType>(Type);
+            if (Success && HasValue(Event.Type))
+                Success = ReadRaw(Data, Position, Event.Value.x) && ReadRaw(Data, Position, Event.Value.y);
+
+            if (!Success)
+            {
+                Log::Error<LogCategory::Window>("Input recording is damaged at frame {}", FrameIndex);
+                return false;
+            }
+
+            Event.Action = static_cast<InputAction>(Action);
+            Event.Code = static_cast<u16>(Code);
+            Event.Mods = static_cast<i32>(static_cast<i64>(Mods >> 1) ^ -static_cast<i64>(Mods & 1));
+            Event.Time = FrameTime + TimeOffset;
+            FrameEvents.push_back(Event);
+        }
+
+        Events.insert(Events.end(), FrameEvents.begin(), FrameEvents.end());
+        DeltaTime = FrameDeltaTime;
+        Offset = Position;
+        FrameIndex++;
+        return true;
+    }
+
+    u64 InputReplay::GetFrameIndex() const
+    {
+        return FrameIndex;
+    }
+}
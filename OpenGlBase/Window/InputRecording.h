@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "InputEvents.h"
+
+namespace Base
+{
+    //a recording is a header followed by one record per Tick holding that Tick's delta time and every
+    //event it drained. event times are stored relative to the Tick so a replay can put them on its own
+    //clock, cursor, scroll and window events carry their two values and keys and buttons don't
+    //
+    //  Frame  varint frame index since the recording started, f64 delta time, varint event count, events
+    //  Event  u8 type, u8 action, varint code, varint zigzag mods, f32 time offset, [f64 x, f64 y]
+    constexpr u32 InputRecordingMagic = 0x52424C47; //"GLBR"
+    constexpr u32 InputRecordingVersion = 1;
+
+    class InputRecorder
+    {
+    public:
+        bool Open(const std::string& Path);
+        void Close();
+        bool IsOpen() const;
+
+        //FrameTime is the glfwGetTime the Tick's delta was taken at
+        void WriteFrame(f64 DeltaTime, f64 FrameTime, const std::vector<InputEvent>& Events);
+
+    private:
+        std::ofstream File;
+        std::string Buffer;
+        u64 FrameIndex = 0;
+    };
+
+    class InputReplay
+    {
+    public:
+        //reads the whole file, false if it isn't a recording
+        bool Open(const std::string& Path);
+        void Close();
+        bool IsOpen() const;
+
+        //appends the next frame's events with their times moved onto FrameTime, false at the end or when
+        //the rest of the file is damaged, then nothing is appended and DeltaTime is left alone
+        bool ReadFrame(f64 FrameTime, f64& DeltaTime, std::vector<InputEvent>& Events);
+
+        u64 GetFrameIndex() const;
+
+    private:
+        std::string Data;
+        std::vector<InputEvent> FrameEvents;
+        std::size_t Offset = 0;
+        u64 FrameIndex = 0;
+        bool Loaded = false;
+    };
+}
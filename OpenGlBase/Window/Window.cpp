@@ -1,15 +1,36 @@
 #include "Window.h"
 #include <glfw/glfw3.h>
 #include <glad/glad.h>
+#include <algorithm>
 
 #include "../Debug/Log.h"
+#include "../Debug/Profiler.h"
+#include "../Debug/GpuProfiler.h"
+#include "../Gl/GlExtensions.h"
+#include "../Shader/ShaderManager.h"
+#include "../Shader/ShaderPipeline.h"
 
 namespace Base
 {    
+    //the program and pipeline trackers are per thread, what one remembers from before the context moved
+    //describes another context or none at all
+    static void MakeContextCurrent(GLFWwindow* WindowInstance)
+    {
+        glfwMakeContextCurrent(WindowInstance);
+
+        ShaderProgram::ResetBoundProgram();
+        ShaderPipeline::ResetBoundPipeline();
+    }
+
     Window::Window(const WindowConfig& Config)
+        : InputQueue(Config.InputEventCapacity)
+        , Stats(Config.FrameStatsHistory, Config.StutterFactor)
     {
         assert(Config.Title);
 
+        EventPollRate = Config.EventPollRate > 0.0 ? Config.EventPollRate : 1000.0;
+        Headless = Config.Backend != WindowBackend::Visible;
+
         Monitor = Config.Monitor ? Config.Monitor : glfwGetPrimaryMonitor();
 
         SetWindowHints(Config);
@@ -18,7 +39,7 @@ namespace Base
         
         if (WindowInstance == nullptr)
         {
-            Log::Error("GLFWWindow* WindowInstance == nullptr");
+            Log::Error<LogCategory::Window>("GLFWWindow* WindowInstance == nullptr");
             assert(WindowInstance);
             return;
         }
@@ -29,11 +50,13 @@ namespace Base
         bool GladInitSuccess = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
         if (GladInitSuccess == false)
         {
-            Log::Error("GladInitSuccess == false");
+            Log::Error<LogCategory::Window>("GladInitSuccess == false");
             assert(GladInitSuccess);
             return;
         }
 
+        LoadGlExtensions((GLADloadproc)glfwGetProcAddress);
+
         glfwSetFramebufferSizeCallback(WindowInstance, FrameBufferSizeCallBack);
         glfwSetWindowSizeCallback(WindowInstance, SizeCallBack);
         glfwSetWindowPosCallback(WindowInstance, PositionCallBack);
@@ -43,10 +66,18 @@ namespace Base
         glfwGetWindowSize(WindowInstance, &Size.x, &Size.y);
         glfwGetWindowPos(WindowInstance, &Position.x, &Position.y);
 
-        glfwSwapInterval(0); //disable vsync
+        //so the first MouseDelta is the movement since now and not the distance from the corner
+        glfwGetCursorPos(WindowInstance, &MousePosition.x, &MousePosition.y);
+        LastMousePosition = MousePosition;
+
+        TearControlSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+        SetFramePacing(Config.Pacing, Config.TargetFrameRate);
 
         glViewport(0, 0, Config.Size.x, Config.Size.y);
 
+        if (Headless)
+            ResizeOffscreenFrameBuffer(FrameBufferSize);
+
         if (glfwRawMouseMotionSupported())
             glfwSetInputMode(WindowInstance, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
 
@@ -54,11 +85,22 @@ namespace Base
         glfwSetCursorPosCallback(WindowInstance, CursorPositionCallBack);
         glfwSetMouseButtonCallback(WindowInstance, MouseButtonCallBack);
         glfwSetScrollCallback(WindowInstance, ScrollCallBack);
+
+        //so the first Tick's delta isn't the time since glfwInit
+        LastFrameTime = glfwGetTime();
     }
 
     Window::~Window()
     {   
         assert(WindowInstance);
+
+        if (Headless)
+        {
+            glDeleteFramebuffers(1, &OffscreenFrameBuffer);
+            glDeleteTextures(1, &OffscreenColor);
+            glDeleteRenderbuffers(1, &OffscreenDepthStencil);
+        }
+
         glfwDestroyWindow(WindowInstance);
     }
     
@@ -75,19 +117,125 @@ namespace Base
     {
         assert(WindowInstance);
 
-        LastMousePosition = MousePosition;
-        MouseDelta = MousePosition - LastMousePosition;
-        LastMousePosition = MousePosition;
+        PROFILE_SCOPE("Window::Tick");
 
-        ScrollDelta = ScrollOffset;
-        ScrollOffset = 0.0;
+        {
+            PROFILE_SCOPE("TickCallbacks");
+
+            for (TickCallback& Callback : TickCallbacks)
+                Callback();
+        }
 
         f64 CurrentTime = glfwGetTime();
         DeltaTime = CurrentTime - LastFrameTime;
         LastFrameTime = CurrentTime;
+        Stats.AddFrame(DeltaTime);
         
-        glfwPollEvents();
-        glfwSwapBuffers(WindowInstance);
+        //threaded, the event thread is already filling the queue
+        if (!Threaded)
+        {
+            PROFILE_SCOPE("glfwPollEvents");
+            glfwPollEvents();
+        }
+
+        ApplyInputEvents(CurrentTime);
+        FrameIndex++;
+
+        GpuProfiler::EndFrame();
+
+        Pacer.Wait();
+
+        if (Headless)
+        {
+            //nothing to present, the flush keeps the frame's commands from piling up instead
+            PROFILE_SCOPE("glFlush");
+            glFlush();
+        }
+        else
+        {
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(WindowInstance);
+        }
+
+        Pacer.EndFrame();
+
+        PROFILE_FRAME();
+    }
+
+    void Window::AddTickCallback(TickCallback Callback)
+    {
+        TickCallbacks.push_back(std::move(Callback));
+    }
+
+    void Window::RunThreaded(const std::function<void()>& RenderLoop)
+    {
+        assert(WindowInstance);
+        assert(!Threaded && std::this_thread::get_id() == EventThreadId);
+
+        RenderThreadDone = false;
+        Threaded = true;
+
+        //a context can only be current on one thread at a time
+        glfwMakeContextCurrent(nullptr);
+
+        std::thread RenderThread([&]()
+        {
+            PROFILE_THREAD_NAME("Render");
+            MakeContextCurrent(WindowInstance);
+
+            RenderLoop();
+
+            glfwMakeContextCurrent(nullptr);
+            RenderThreadDone.store(true, std::memory_order_release);
+            glfwPostEmptyEvent();
+        });
+
+        PROFILE_THREAD_NAME("Events");
+
+        while (!RenderThreadDone.load(std::memory_order_acquire))
+        {
+            glfwWaitEventsTimeout(1.0 / EventPollRate);
+            RunEventThreadRequests();
+        }
+
+        RenderThread.join();
+        RunEventThreadRequests();
+
+        Threaded = false;
+        MakeContextCurrent(WindowInstance);
+    }
+
+    bool Window::IsThreaded()
+    {
+        return Threaded;
+    }
+
+    void Window::RunOnEventThread(std::function<void()> Request)
+    {
+        if (!Threaded || std::this_thread::get_id() == EventThreadId)
+        {
+            Request();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock(RequestMutex);
+            EventThreadRequests.push_back(std::move(Request));
+        }
+
+        glfwPostEmptyEvent();
+    }
+
+    void Window::RunEventThreadRequests()
+    {
+        std::vector<std::function<void()>> Requests;
+        {
+            std::lock_guard<std::mutex> Lock(RequestMutex);
+            Requests.swap(EventThreadRequests);
+        }
+
+        for (std::function<void()>& Request : Requests)
+            Request();
     }
 
     ivec2 Window::GetWindowPos()
@@ -105,6 +253,37 @@ namespace Base
         return FrameBufferSize;
     }
 
+    bool Window::IsHeadless()
+    {
+        return Headless;
+    }
+
+    u32 Window::GetFrameBuffer()
+    {
+        return OffscreenFrameBuffer;
+    }
+
+    u32 Window::GetFrameBufferTexture()
+    {
+        return OffscreenColor;
+    }
+
+    void Window::ReadPixels(std::vector<u8>& Rgba)
+    {
+        assert(Headless && OffscreenFrameBuffer != 0);
+
+        Rgba.resize(static_cast<std::size_t>(FrameBufferSize.x) * FrameBufferSize.y * 4);
+
+        GLint PreviousReadFrameBuffer = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &PreviousReadFrameBuffer);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, OffscreenFrameBuffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, FrameBufferSize.x, FrameBufferSize.y, GL_RGBA, GL_UNSIGNED_BYTE, Rgba.data());
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, PreviousReadFrameBuffer);
+    }
+
     GLFWwindow* Window::GetGLFWWindow()
     {
         return WindowInstance;
@@ -120,6 +299,37 @@ namespace Base
         return DeltaTime;
     }
 
+    const FrameStats& Window::GetFrameStats()
+    {
+        return Stats;
+    }
+
+    void Window::ResetFrameStats()
+    {
+        Stats.Reset();
+    }
+
+    void Window::SetFramePacing(FramePacingMode Mode, f64 TargetFrameRate)
+    {
+        assert(WindowInstance);
+
+        if (Mode == FramePacingMode::AdaptiveVSync && !TearControlSupported)
+            Log::Warning<LogCategory::Window>("Adaptive vsync isn't supported by the driver, using vsync");
+
+        Pacer.SetMode(Mode, TargetFrameRate);
+        glfwSwapInterval(Pacer.GetSwapInterval(TearControlSupported));
+    }
+
+    FramePacingMode Window::GetFramePacing()
+    {
+        return Pacer.GetMode();
+    }
+
+    const FramePacingTimes& Window::GetFramePacingTimes()
+    {
+        return Pacer.GetTimes();
+    }
+
     void Window::Close()
     {
         PendingClose = true;
@@ -129,14 +339,14 @@ namespace Base
     {
         assert(WindowInstance);
         
-        glfwSetWindowPos(WindowInstance, Position.x, Position.y);
+        RunOnEventThread([this, NewPosition]() { glfwSetWindowPos(WindowInstance, NewPosition.x, NewPosition.y); });
     }
 
     void Window::SetWindowSize(const ivec2& Size)
     {
         assert(WindowInstance);
         
-        glfwSetWindowSize(WindowInstance, Size.x, Size.y);
+        RunOnEventThread([this, Size]() { glfwSetWindowSize(WindowInstance, Size.x, Size.y); });
     }
 
     void Window::ToggleFullscreen()
@@ -144,32 +354,37 @@ namespace Base
         assert(WindowInstance);
         assert(Monitor);
 
-        if (IsFullScreen())
-        {
-            glfwSetWindowMonitor(WindowInstance, nullptr, LastWindowedPosition.x, LastWindowedPosition.y, LastWindowedSize.x, LastWindowedSize.y, 0);
-        }
-        else
+        RunOnEventThread([this]()
         {
-            LastWindowedPosition = GetWindowPos();
-            LastWindowedSize = GetWindowSize();
-            
-            const GLFWvidmode* VideoMode = glfwGetVideoMode(Monitor);
-            
-            glfwSetWindowMonitor(WindowInstance, Monitor, 0, 0, VideoMode->width, VideoMode->height, VideoMode->refreshRate);
-        }
+            if (glfwGetWindowMonitor(WindowInstance))
+            {
+                glfwSetWindowMonitor(WindowInstance, nullptr, LastWindowedPosition.x, LastWindowedPosition.y, LastWindowedSize.x, LastWindowedSize.y, 0);
+            }
+            else
+            {
+                //asked from GLFW, Position and Size belong to the render thread when threaded
+                glfwGetWindowPos(WindowInstance, &LastWindowedPosition.x, &LastWindowedPosition.y);
+                glfwGetWindowSize(WindowInstance, &LastWindowedSize.x, &LastWindowedSize.y);
+
+                const GLFWvidmode* VideoMode = glfwGetVideoMode(Monitor);
+
+                glfwSetWindowMonitor(WindowInstance, Monitor, 0, 0, VideoMode->width, VideoMode->height, VideoMode->refreshRate);
+            }
+        });
     }
 
     void Window::Minimize()
     {
         assert(WindowInstance);
-        glfwIconifyWindow(WindowInstance);
+
+        RunOnEventThread([this]() { glfwIconifyWindow(WindowInstance); });
     }
 
     void Window::SetCursorMode(CursorModes Mode)
     {
         assert(WindowInstance);
         
-        glfwSetInputMode(WindowInstance, GLFW_CURSOR, ConvertToGLFWCursorMode(Mode));
+        RunOnEventThread([this, Mode]() { glfwSetInputMode(WindowInstance, GLFW_CURSOR, ConvertToGLFWCursorMode(Mode)); });
     }
 
     dvec2 Window::GetMousePosition()
@@ -187,9 +402,52 @@ namespace Base
         return ScrollDelta;
     }
 
+    u64 Window::GetFrameIndex()
+    {
+        return FrameIndex;
+    }
+
+    bool Window::StartRecording(const std::string& Path)
+    {
+        StopReplay();
+        return Recorder.Open(Path);
+    }
+
+    void Window::StopRecording()
+    {
+        Recorder.Close();
+    }
+
+    bool Window::IsRecording()
+    {
+        return Recorder.IsOpen();
+    }
+
+    bool Window::StartReplay(const std::string& Path, f64 FixedDeltaTime)
+    {
+        StopRecording();
+        ReplayDeltaTime = FixedDeltaTime;
+        return Replay.Open(Path);
+    }
+
+    void Window::StopReplay()
+    {
+        Replay.Close();
+    }
+
+    bool Window::IsReplaying()
+    {
+        return Replay.IsOpen();
+    }
+
+    const std::vector<InputEvent>& Window::GetInputEvents()
+    {
+        return FrameEvents;
+    }
+
     bool Window::IsMouseButtonDown(MouseButtonCodes Button)
     {
-        return MouseButtons[Button].Pressed;
+        return MouseButtons[Button].Down;
     }
 
     const char* GetMouseButtonName(MouseButtonCodes Button)
@@ -210,22 +468,27 @@ namespace Base
 
     bool Window::WasMouseButtonJustPressed(MouseButtonCodes Button)
     {
-        if (MouseButtons[Button].Pressed && MouseButtons[Button].Released)
-        {
-            MouseButtons[Button].Released = false;
-            return true;
-        }
-        else return false;
+        return MouseButtons[Button].Presses > 0;
+    }
+
+    bool Window::WasMouseButtonJustReleased(MouseButtonCodes Button)
+    {
+        return MouseButtons[Button].Releases > 0;
+    }
+
+    u32 Window::GetMouseButtonPressCount(MouseButtonCodes Button)
+    {
+        return MouseButtons[Button].Presses;
     }
 
     f64 Window::GetTimeSinceMouseButtonPressed(MouseButtonCodes Button)
     {
-        return glfwGetTime() - MouseButtons[Button].TimeSincePressed;
+        return glfwGetTime() - MouseButtons[Button].PressTime;
     }
 
     bool Window::IsKeyDown(KeyCodes Key)
     {
-        return Keys[Key].Pressed;
+        return Keys[Key].Down;
     }
 
     const char* Window::GetKeyName(KeyCodes Key)
@@ -369,17 +632,22 @@ namespace Base
 
     bool Window::WasKeyJustPressed(KeyCodes Key)
     {
-        if (Keys[Key].Pressed && Keys[Key].Released)
-        {
-            Keys[Key].Released = false;
-            return true;
-        }
-        else return false;
+        return Keys[Key].Presses > 0;
+    }
+
+    bool Window::WasKeyJustReleased(KeyCodes Key)
+    {
+        return Keys[Key].Releases > 0;
+    }
+
+    u32 Window::GetKeyPressCount(KeyCodes Key)
+    {
+        return Keys[Key].Presses;
     }
 
     f64 Window::GetTimeSinceKeyPressed(KeyCodes Key)
     {
-        return glfwGetTime() - Keys[Key].TimeSincePressed;
+        return glfwGetTime() - Keys[Key].PressTime;
     }
 
     bool Window::IsFullScreen()
@@ -398,6 +666,54 @@ namespace Base
         glfwWindowHint(GLFW_DECORATED, Config.HaveDecorations);
         glfwWindowHint(GLFW_FOCUSED, Config.InituiallyFocused);
         glfwWindowHint(GLFW_CENTER_CURSOR, Config.CenterCursorOnStartup);
+
+        if (Config.Backend != WindowBackend::Visible)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_FOCUSED, GLFW_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, Config.Backend == WindowBackend::HeadlessEgl ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+        }
+
+        if (Config.GlVersion.x != 0)
+        {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, Config.GlVersion.x);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, Config.GlVersion.y);
+
+            //profiles only exist from 3.2 on
+            if (Config.GlVersion.x > 3 || (Config.GlVersion.x == 3 && Config.GlVersion.y >= 2))
+                glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        }
+    }
+
+    void Window::ResizeOffscreenFrameBuffer(const ivec2& NewSize)
+    {
+        //a minimized window reports 0x0, keep the old buffer rather than making an incomplete one
+        if (NewSize.x <= 0 || NewSize.y <= 0)
+            return;
+
+        if (OffscreenFrameBuffer == 0)
+        {
+            glGenFramebuffers(1, &OffscreenFrameBuffer);
+            glGenTextures(1, &OffscreenColor);
+            glGenRenderbuffers(1, &OffscreenDepthStencil);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, OffscreenColor);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, NewSize.x, NewSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, OffscreenDepthStencil);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, NewSize.x, NewSize.y);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, OffscreenFrameBuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, OffscreenColor, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, OffscreenDepthStencil);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            Log::Error<LogCategory::Window>("Offscreen framebuffer of {}x{} is incomplete", NewSize.x, NewSize.y);
     }
 
     void Window::SetSizeInternal(const ivec2& NewSize)
@@ -413,6 +729,132 @@ namespace Base
         FrameBufferSize = NewFrameBufferSize;
     }
 
+    void Window::PushInputEvent(const InputEvent& Event)
+    {
+        InputQueue.Push(Event);
+    }
+
+    void Window::PushWindowEvent(const InputEvent& Event)
+    {
+        u32 Index = static_cast<u32>(Event.Type) - static_cast<u32>(InputEventType::WindowSize);
+        assert(Index < WindowEvents.size());
+
+        std::lock_guard<std::mutex> Lock(WindowEventMutex);
+        WindowEvents[Index] = Event;
+        WindowEventsPending[Index] = true;
+    }
+
+    void Window::ApplyButtonEvent(Key& Button, const InputEvent& Event)
+    {
+        if (Event.Action == InputAction::Press)
+        {
+            Button.Down = true;
+            Button.Presses++;
+            Button.PressTime = Event.Time;
+        }
+        else if (Event.Action == InputAction::Release)
+        {
+            Button.Down = false;
+            Button.Releases++;
+            Button.PressTime = 0.0;
+        }
+    }
+
+    void Window::ApplyInputEvents(f64 FrameTime)
+    {
+        for (Key& Button : Keys)
+            Button.Presses = Button.Releases = 0;
+        for (Key& Button : MouseButtons)
+            Button.Presses = Button.Releases = 0;
+
+        LastMousePosition = MousePosition;
+        ScrollDelta = 0.0;
+
+        FrameEvents.clear();
+        InputQueue.Drain(FrameEvents);
+
+        if (u32 Dropped = InputQueue.TakeDropped())
+            Log::Warning<LogCategory::Window>("Input event queue was full, dropped {} events", Dropped);
+
+        {
+            std::size_t QueuedCount = FrameEvents.size();
+            std::lock_guard<std::mutex> Lock(WindowEventMutex);
+
+            for (std::size_t i = 0; i < WindowEvents.size(); i++)
+            {
+                if (WindowEventsPending[i])
+                    FrameEvents.push_back(WindowEvents[i]);
+
+                WindowEventsPending[i] = false;
+            }
+
+            auto ByTime = [](const InputEvent& A, const InputEvent& B) { return A.Time < B.Time; };
+            std::sort(FrameEvents.begin() + QueuedCount, FrameEvents.end(), ByTime);
+            std::inplace_merge(FrameEvents.begin(), FrameEvents.begin() + QueuedCount, FrameEvents.end(), ByTime);
+        }
+
+        if (Replay.IsOpen())
+        {
+            //live events, window ones included, are dropped so the frame only sees what was recorded
+            FrameEvents.clear();
+
+            f64 RecordedDeltaTime = 0.0;
+            if (Replay.ReadFrame(FrameTime, RecordedDeltaTime, FrameEvents))
+            {
+                DeltaTime = ReplayDeltaTime > 0.0 ? ReplayDeltaTime : RecordedDeltaTime;
+            }
+            else
+            {
+                Log::Info<LogCategory::Window>("Input replay finished after {} frames", Replay.GetFrameIndex());
+                Replay.Close();
+            }
+        }
+        else if (Recorder.IsOpen())
+        {
+            Recorder.WriteFrame(DeltaTime, FrameTime, FrameEvents);
+        }
+
+        for (const InputEvent& Event : FrameEvents)
+        {
+            switch (Event.Type)
+            {
+                case(InputEventType::Key):
+                    if (Event.Code < Keys.size())
+                        ApplyButtonEvent(Keys[Event.Code], Event);
+                    break;
+                case(InputEventType::MouseButton):
+                    if (Event.Code < MouseButtons.size())
+                        ApplyButtonEvent(MouseButtons[Event.Code], Event);
+                    break;
+                case(InputEventType::CursorPosition): MousePosition = Event.Value; break;
+                case(InputEventType::Scroll): ScrollDelta += Event.Value.x; break;
+                case(InputEventType::WindowSize): SetSizeInternal(ivec2(Event.Value)); break;
+                case(InputEventType::WindowPosition): SetPositionInternal(ivec2(Event.Value)); break;
+                case(InputEventType::FrameBufferSize):
+                    //here rather than in the callback, which runs on the event thread when threaded
+                    glViewport(0, 0, static_cast<GLsizei>(Event.Value.x), static_cast<GLsizei>(Event.Value.y));
+                    SetFrameBufferSizeInternal(ivec2(Event.Value));
+
+                    if (Headless)
+                        ResizeOffscreenFrameBuffer(FrameBufferSize);
+                    break;
+            }
+        }
+
+        MouseDelta = MousePosition - LastMousePosition;
+    }
+
+    static InputAction ConvertGLFWAction(int Action)
+    {
+        switch (Action)
+        {
+            case(GLFW_PRESS): return InputAction::Press;
+            case(GLFW_REPEAT): return InputAction::Repeat;
+        }
+
+        return InputAction::Release;
+    }
+
     constexpr KeyCodes Window::ConvertGLFWKey(i32 GLFWKey)
     {
         switch (GLFWKey)
@@ -583,7 +1025,12 @@ namespace Base
         
         Window* Self = (Window*)glfwGetWindowUserPointer(WindowInstance);
         
-        Self->SetPositionInternal(ivec2{ X, Y });
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::WindowPosition;
+        Event.Value = { X, Y };
+
+        Self->PushWindowEvent(Event);
     }
 
     void Window::SizeCallBack(GLFWwindow* WindowInstance, int Width, int Height)
@@ -592,7 +1039,12 @@ namespace Base
 
         assert(WindowObject);
 
-        WindowObject->SetSizeInternal(ivec2{ Width, Height });
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::WindowSize;
+        Event.Value = { Width, Height };
+
+        WindowObject->PushWindowEvent(Event);
     }
 
     void Window::FrameBufferSizeCallBack(GLFWwindow* WindowInstance, int Width, int Height)
@@ -601,31 +1053,28 @@ namespace Base
 
         assert(WindowObject);
 
-        glViewport(0, 0, Width, Height);
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::FrameBufferSize;
+        Event.Value = { Width, Height };
 
-        WindowObject->SetFrameBufferSizeInternal(ivec2{ Width, Height });
+        WindowObject->PushWindowEvent(Event);
     }
 
     void Window::KeyCallBack(GLFWwindow* WindowInstance, int Key, int Scancode, int Action, int Mods)
     {
         Window* WindowObject = static_cast<Window*>(glfwGetWindowUserPointer(WindowInstance));
 
-        KeyCodes KeyCode = ConvertGLFWKey(Key);
-
-
         assert(WindowObject);
 
-        if (Action == GLFW_PRESS)
-        {
-            WindowObject->Keys[KeyCode].Pressed = true;
-            WindowObject->Keys[KeyCode].TimeSincePressed = glfwGetTime();
-        }
-        else if (Action == GLFW_RELEASE)
-        {
-            WindowObject->Keys[KeyCode].Released = true;
-            WindowObject->Keys[KeyCode].Pressed = false;
-            WindowObject->Keys[KeyCode].TimeSincePressed = 0;
-        }
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::Key;
+        Event.Action = ConvertGLFWAction(Action);
+        Event.Code = static_cast<u16>(ConvertGLFWKey(Key));
+        Event.Mods = Mods;
+
+        WindowObject->PushInputEvent(Event);
     }
 
     void Window::CursorPositionCallBack(GLFWwindow* WindowInstance, double XPosition, double YPosition)
@@ -634,29 +1083,28 @@ namespace Base
 
         assert(WindowObject);
 
-        WindowObject->MousePosition.x = XPosition;
-        WindowObject->MousePosition.y = YPosition;
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::CursorPosition;
+        Event.Value = { XPosition, YPosition };
+
+        WindowObject->PushInputEvent(Event);
     }
 
     void Window::MouseButtonCallBack(GLFWwindow* WindowInstance, int Button, int Action, int Mods)
     {
         Window* WindowObject = static_cast<Window*>(glfwGetWindowUserPointer(WindowInstance));
 
-        MouseButtonCodes MouseButtonCode = ConvertGLFWMouseButton(Button);
-
         assert(WindowObject);
 
-        if (Action == GLFW_PRESS)
-        {
-            WindowObject->MouseButtons[MouseButtonCode].Pressed = true;
-            WindowObject->MouseButtons[MouseButtonCode].TimeSincePressed = glfwGetTime();
-        }
-        else if (Action == GLFW_RELEASE)
-        {
-            WindowObject->MouseButtons[MouseButtonCode].Released = true;
-            WindowObject->MouseButtons[MouseButtonCode].Pressed = false;
-            WindowObject->MouseButtons[MouseButtonCode].TimeSincePressed = 0;
-        }
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::MouseButton;
+        Event.Action = ConvertGLFWAction(Action);
+        Event.Code = static_cast<u16>(ConvertGLFWMouseButton(Button));
+        Event.Mods = Mods;
+
+        WindowObject->PushInputEvent(Event);
     }
 
     void Window::ScrollCallBack(GLFWwindow* WindowInstance, double XOffset, double YOffset)
@@ -665,6 +1113,11 @@ namespace Base
 
         assert(WindowObject);
 
-        WindowObject->ScrollOffset += XOffset;
+        InputEvent Event;
+        Event.Time = glfwGetTime();
+        Event.Type = InputEventType::Scroll;
+        Event.Value = { XOffset, YOffset };
+
+        WindowObject->PushInputEvent(Event);
     }
 }
\ No newline at end of file
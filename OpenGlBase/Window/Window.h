@@ -1,10 +1,16 @@
 #pragma once
 #include <vector>
 #include <array>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <glm/glm.hpp>
 
-// TODO:
-//  Error handling on GLFW init failure
+#include "FrameStats.h"
+#include "FramePacer.h"
+#include "InputEvents.h"
+#include "InputRecording.h"
 
 struct GLFWwindow;
 struct GLFWmonitor;
@@ -17,6 +23,17 @@ namespace Base
         i32 Value;
     };
     
+    enum class WindowBackend : u8
+    {
+        Visible,
+
+        //no window on screen, the context renders into an offscreen framebuffer the size of the window.
+        //with Base::InitConfig::Headless they run without a display, EGL surfaceless needs a Mesa or
+        //vendor EGL, OSMesa only a software rasterizer like llvmpipe
+        HeadlessEgl,
+        HeadlessOSMesa
+    };
+
     struct WindowConfig
     {
         uvec2 Pos = { 0, 0 };
@@ -31,6 +48,28 @@ namespace Base
         bool InituiallyFocused = true;
         bool CenterCursorOnStartup = false;
 
+        //requests a core profile of at least this version, 0.0 takes whatever the driver
+        //gives by default, compute shaders and storage buffers need 4.3
+        uvec2 GlVersion = { 0, 0 };
+
+        WindowBackend Backend = WindowBackend::Visible;
+
+        //frames kept for GetFrameStats percentiles, and how many times the recent average
+        //a frame has to take to count as a stutter
+        u32 FrameStatsHistory = 1024;
+        f64 StutterFactor = 2.0;
+
+        //TargetFrameRate is only used by FramePacingMode::FixedRate
+        FramePacingMode Pacing = FramePacingMode::Uncapped;
+        f64 TargetFrameRate = 60.0;
+
+        //input events that can be queued between two Ticks, more than that are dropped
+        u32 InputEventCapacity = 1024;
+
+        //with RunThreaded, how often the event thread wakes up at least. events are handled as soon
+        //as they arrive either way
+        f64 EventPollRate = 1000.0;
+
     };
 
     enum CursorModes
@@ -151,13 +190,45 @@ namespace Base
         bool ShouldClose();
         void Tick();
 
+        //called at the start of every Tick, for per frame work like polling a ShaderCompileQueue
+        using TickCallback = std::function<void()>;
+        void AddTickCallback(TickCallback Callback);
+
+        //moves the GL context to a new render thread and runs RenderLoop there, usually a loop of
+        //drawing and Tick until ShouldClose. the calling thread, which has to be the one that created
+        //the window, only pumps events into the input queue until RenderLoop returns, so moving or
+        //resizing the window doesn't hold up rendering and input isn't bound to the frame rate.
+        //window functions called from the render thread are forwarded to the event thread
+        void RunThreaded(const std::function<void()>& RenderLoop);
+        bool IsThreaded();
+
         ivec2 GetWindowPos();
         ivec2 GetWindowSize();
         ivec2 GetFrameBufferSize();
+
+        //what to bind to draw to the window, 0 unless it's headless. headless it's an RGBA8 color
+        //texture with a depth stencil buffer that follows GetFrameBufferSize like the default one would
+        bool IsHeadless();
+        u32 GetFrameBuffer();
+        u32 GetFrameBufferTexture();
+
+        //the window's current contents, bottom row first, 4 bytes a pixel. headless only, a visible
+        //window's back buffer is undefined once it has been swapped
+        void ReadPixels(std::vector<u8>& Rgba);
         GLFWwindow* GetGLFWWindow();
         GLFWmonitor* GetPrimaryMonitor();
         f64 GetDeltaTime();
 
+        //every Tick's delta time, percentiles, stutters and a histogram of the whole run
+        const FrameStats& GetFrameStats();
+        void ResetFrameStats();
+
+        //sets the swap interval as well so it has to be called where the context is current, the render
+        //thread when threaded. a TargetFrameRate of 0 keeps the current one
+        void SetFramePacing(FramePacingMode Mode, f64 TargetFrameRate = 0.0);
+        FramePacingMode GetFramePacing();
+        const FramePacingTimes& GetFramePacingTimes();
+
         void Close();
         void SetWindowPos(const ivec2& NewPosition);
         void SetWindowSize(const ivec2& Size);
@@ -171,22 +242,50 @@ namespace Base
         dvec2 GetMouseDelta();
         f64 GetScrollDelta();
 
+        //every input event drained by the last Tick in the order it happened, the queries below are
+        //all worked out from these so a key pressed and released within one frame still shows up
+        const std::vector<InputEvent>& GetInputEvents();
+
+        //Ticks since the window was created
+        u64 GetFrameIndex();
+
+        //writes every Tick's delta time and drained events, window callbacks included, to Path
+        bool StartRecording(const std::string& Path);
+        void StopRecording();
+        bool IsRecording();
+
+        //from the next Tick on, live events are ignored and each Tick hands out a recorded frame's events
+        //and delta time instead, or FixedDeltaTime if it isn't 0, until the recording runs out. the
+        //window should be created at the size it was recorded at. GetFrameStats keeps measuring the real
+        //frame times so replays of the same recording can be compared
+        bool StartReplay(const std::string& Path, f64 FixedDeltaTime = 0.0);
+        void StopReplay();
+        bool IsReplaying();
+
         bool IsMouseButtonDown(MouseButtonCodes Button);
         static const char* GetMouseButtonName(MouseButtonCodes Button);
         bool WasMouseButtonJustPressed(MouseButtonCodes Button);
+        bool WasMouseButtonJustReleased(MouseButtonCodes Button);
+        u32 GetMouseButtonPressCount(MouseButtonCodes Button);
         f64 GetTimeSinceMouseButtonPressed(MouseButtonCodes Button);
 
+        //the Just and Count queries are about the events from the last Tick, they don't change anything
+        //so they can be asked any number of times in a frame
         bool IsKeyDown(KeyCodes Key);
         static const char* GetKeyName(KeyCodes Key);
         bool WasKeyJustPressed(KeyCodes Key);
+        bool WasKeyJustReleased(KeyCodes Key);
+        u32 GetKeyPressCount(KeyCodes Key);
         f64 GetTimeSinceKeyPressed(KeyCodes Key);
 
     private:
+        //Presses and Releases only count the last Tick's events
         struct Key
         {
-            bool Pressed = false;
-            bool Released = true; 
-            f64 TimeSincePressed = 0.0;
+            bool Down = false;
+            u16 Presses = 0;
+            u16 Releases = 0;
+            f64 PressTime = 0.0;
         };
 
         std::array<Key, NumKeyCodes> Keys;
@@ -196,7 +295,20 @@ namespace Base
         dvec2 LastMousePosition = { 0.0, 0.0 };
         dvec2 MouseDelta = { 0.0, 0.0 };
         f64 ScrollDelta = 0.0;
-        f64 ScrollOffset= 0.0;
+
+        InputEventQueue InputQueue;
+        std::vector<InputEvent> FrameEvents;
+
+        //the latest size, framebuffer size and position event, by InputEventType from WindowSize on. they
+        //skip the queue so a full one can't lose a resize, only the newest of each kind matters anyway
+        std::mutex WindowEventMutex;
+        std::array<InputEvent, 3> WindowEvents;
+        std::array<bool, 3> WindowEventsPending = {};
+        u64 FrameIndex = 0;
+
+        InputRecorder Recorder;
+        InputReplay Replay;
+        f64 ReplayDeltaTime = 0.0;
 
         GLFWwindow* WindowInstance = nullptr;
         GLFWmonitor* Monitor = nullptr;
@@ -208,15 +320,43 @@ namespace Base
 
         f64 DeltaTime = 0.0;
         f64 LastFrameTime = 0.0;
+        FrameStats Stats;
+        FramePacer Pacer;
+        bool TearControlSupported = false;
 
         ivec2 LastWindowedSize = { 0, 0 };
         ivec2 LastWindowedPosition = { 0, 0 };
 
+        std::atomic<bool> Threaded = false;
+        std::atomic<bool> RenderThreadDone = false;
+        std::thread::id EventThreadId = std::this_thread::get_id();
+        f64 EventPollRate = 1000.0;
+
+        std::mutex RequestMutex;
+        std::vector<std::function<void()>> EventThreadRequests;
+
+        std::vector<TickCallback> TickCallbacks;
+
+        bool Headless = false;
+        u32 OffscreenFrameBuffer = 0;
+        u32 OffscreenColor = 0;
+        u32 OffscreenDepthStencil = 0;
+
         void SetWindowHints(const WindowConfig& Config);
+        void ResizeOffscreenFrameBuffer(const ivec2& NewSize);
 
         void SetPositionInternal(const ivec2& NewPosition);
         void SetSizeInternal(const ivec2& NewSize);
         void SetFrameBufferSizeInternal(const ivec2& NewFrameBufferSize);
+
+        //GLFW only allows most window functions on the thread that created the window
+        void RunOnEventThread(std::function<void()> Request);
+        void RunEventThreadRequests();
+
+        void PushInputEvent(const InputEvent& Event);
+        void PushWindowEvent(const InputEvent& Event);
+        void ApplyInputEvents(f64 FrameTime);
+        static void ApplyButtonEvent(Key& Button, const InputEvent& Event);
         
         static constexpr KeyCodes ConvertGLFWKey(i32 GLFWKey);
         static constexpr MouseButtonCodes ConvertGLFWMouseButton(i32 GLFWMouseButton);
@@ -0,0 +1,55 @@
+//LogDecode <binary log> [output]
+//
+//turns a log written with LogFileFormat::Binary back into the same text the log writes to stderr,
+//to stdout when no output path is given
+
+#include "../../OpenGlBase/Debug/LogFormat.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+using namespace Base;
+
+int main(int ArgumentCount, char** Arguments)
+{
+    if (ArgumentCount < 2 || ArgumentCount > 3)
+    {
+        std::cerr << "usage: LogDecode <binary log> [output]\n";
+        return 1;
+    }
+
+    std::ifstream Input(Arguments[1], std::ios::binary);
+    if (!Input)
+    {
+        std::cerr << "Failed to read " << Arguments[1] << "\n";
+        return 1;
+    }
+
+    std::string Data((std::istreambuf_iterator<char>(Input)), std::istreambuf_iterator<char>());
+
+    std::string Text;
+    bool Complete = Log::DecodeBinaryLog(Data, Text);
+
+    if (ArgumentCount == 3)
+    {
+        std::ofstream Output(Arguments[2], std::ios::binary | std::ios::trunc);
+        if (!Output || !Output.write(Text.data(), Text.size()))
+        {
+            std::cerr << "Failed to write " << Arguments[2] << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << Text;
+    }
+
+    //a run that crashed mid write still decodes up to the damaged record
+    if (!Complete)
+    {
+        std::cerr << Arguments[1] << " is truncated, damaged or not a binary log, decoded what came before\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,383 @@
+//ShaderCook <manifest> <output archive> [options]
+//
+//preprocesses every program listed in the manifest, validates it and packs the result into a ShaderArchive
+//so the runtime never has to read, expand or validate shader text
+//
+//  --root <dir>        directory the manifest paths and #includes are relative to, defaults to the manifest's
+//  --glslang <path>    glslangValidator to validate every stage with, stages are only preprocessed without it
+//  --spirv             also compile every stage to SPIR-V for GL_ARB_gl_spirv drivers, needs --glslang
+//  --depfile <path>    writes a make style dependency file with every file that was read
+//
+//every manifest line is one program, # starts a comment
+//
+//  Name [vertex=path] [fragment=path] [geometry=path] [compute=path] [define=NAME[=VALUE]]... [separable]
+
+#include "../../OpenGlBase/Shader/ShaderArchive.h"
+#include "../../OpenGlBase/Shader/ShaderPreprocessor.h"
+#include "../../OpenGlBase/FileSystem/VirtualFileSystem.h"
+#include "../../OpenGlBase/Util/Hash.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace Base;
+
+struct CookOptions
+{
+    std::string ManifestPath;
+    std::string OutputPath;
+    std::string Root;
+    std::string Glslang;
+    std::string DepFile;
+    bool Spirv = false;
+};
+
+struct CookProgram
+{
+    std::string Name;
+    std::string Paths[4];
+    std::vector<ShaderDefine> Defines;
+    bool Separable = false;
+    u32 Line = 0;
+};
+
+static const char* const StageNames[] = { "vertex", "fragment", "geometry", "compute" };
+
+//glslangValidator picks the stage from the file extension
+static const char* const StageExtensions[] = { "vert", "frag", "geom", "comp" };
+
+static void PrintUsage()
+{
+    std::cerr << "usage: ShaderCook <manifest> <output archive> [--root <dir>] [--glslang <path>] [--spirv] [--depfile <path>]\n";
+}
+
+static bool ParseArguments(int ArgumentCount, char** Arguments, CookOptions& Options)
+{
+    std::vector<std::string> Positional;
+
+    for (int i = 1; i < ArgumentCount; i++)
+    {
+        std::string Argument = Arguments[i];
+        bool HasValue = i + 1 < ArgumentCount;
+
+        if (Argument == "--root" && HasValue) Options.Root = Arguments[++i];
+        else if (Argument == "--glslang" && HasValue) Options.Glslang = Arguments[++i];
+        else if (Argument == "--depfile" && HasValue) Options.DepFile = Arguments[++i];
+        else if (Argument == "--spirv") Options.Spirv = true;
+        else if (Argument.rfind("--", 0) == 0)
+        {
+            std::cerr << "Unknown option " << Argument << "\n";
+            return false;
+        }
+        else Positional.push_back(Argument);
+    }
+
+    if (Positional.size() != 2)
+        return false;
+
+    Options.ManifestPath = Positional[0];
+    Options.OutputPath = Positional[1];
+
+    if (Options.Root.empty())
+        Options.Root = std::filesystem::path(Options.ManifestPath).parent_path().string();
+
+    if (Options.Spirv && Options.Glslang.empty())
+    {
+        std::cerr << "--spirv needs --glslang\n";
+        return false;
+    }
+
+    return true;
+}
+
+static bool ParseManifest(const std::string& Path, std::vector<CookProgram>& Programs)
+{
+    std::ifstream File(Path);
+    if (!File)
+    {
+        std::cerr << "Failed to read manifest " << Path << "\n";
+        return false;
+    }
+
+    bool Success = true;
+    std::string Line;
+
+    for (u32 LineNumber = 1; std::getline(File, Line); LineNumber++)
+    {
+        Line = Line.substr(0, Line.find('#'));
+
+        std::istringstream Tokens(Line);
+        CookProgram Program;
+        Program.Line = LineNumber;
+
+        if (!(Tokens >> Program.Name))
+            continue;
+
+        std::string Token;
+        while (Tokens >> Token)
+        {
+            std::size_t Equals = Token.find('=');
+            std::string Key = Token.substr(0, Equals);
+            std::string Value = Equals == std::string::npos ? "" : Token.substr(Equals + 1);
+
+            auto Stage = std::find(std::begin(StageNames), std::end(StageNames), Key);
+
+            if (Key == "separable" && Equals == std::string::npos)
+            {
+                Program.Separable = true;
+            }
+            else if (Key == "define" && !Value.empty())
+            {
+                std::size_t ValueEquals = Value.find('=');
+                if (ValueEquals == std::string::npos)
+                    Program.Defines.push_back({ Value });
+                else
+                    Program.Defines.push_back({ Value.substr(0, ValueEquals), Value.substr(ValueEquals + 1) });
+            }
+            else if (Stage != std::end(StageNames) && !Value.empty())
+            {
+                Program.Paths[std::distance(std::begin(StageNames), Stage)] = Value;
+            }
+            else
+            {
+                std::cerr << Path << "(" << LineNumber << "): unknown entry " << Token << "\n";
+                Success = false;
+            }
+        }
+
+        Programs.push_back(std::move(Program));
+    }
+
+    return Success;
+}
+
+//the same rules ShaderProgram asserts on, caught here so a bad manifest fails the build instead of the game
+static bool ValidateStages(const CookProgram& Program)
+{
+    bool Graphics = !Program.Paths[0].empty() || !Program.Paths[1].empty() || !Program.Paths[2].empty();
+    bool Compute = !Program.Paths[3].empty();
+
+    if (Graphics == Compute)
+    {
+        std::cerr << Program.Name << ": needs either graphics stages or a compute stage\n";
+        return false;
+    }
+
+    if (Graphics && !Program.Separable && (Program.Paths[0].empty() || Program.Paths[1].empty()))
+    {
+        std::cerr << Program.Name << ": a program that isn't separable needs a vertex and a fragment stage\n";
+        return false;
+    }
+
+    return true;
+}
+
+static int RunCommand(std::string Command)
+{
+#ifdef _WIN32
+    //cmd strips the outer quotes of the whole line, which would otherwise eat the ones around the executable
+    Command = "\"" + Command + "\"";
+#endif
+
+    return std::system(Command.c_str());
+}
+
+static bool ReadSpirv(const std::filesystem::path& Path, std::vector<u32>& Words)
+{
+    std::ifstream File(Path, std::ios::binary | std::ios::ate);
+    if (!File)
+        return false;
+
+    std::streamsize Size = File.tellg();
+    if (Size <= 0 || Size % sizeof(u32) != 0)
+        return false;
+
+    Words.resize(static_cast<std::size_t>(Size) / sizeof(u32));
+
+    File.seekg(0);
+    return static_cast<bool>(File.read(reinterpret_cast<char*>(Words.data()), Size));
+}
+
+//runs glslangValidator over the preprocessed text, which is what the driver will see at runtime
+static bool CompileStage(const CookOptions& Options, const std::filesystem::path& TempDirectory, const std::string& Name, u32 Stage, const std::string& Source, std::vector<u32>& Spirv)
+{
+    std::filesystem::path SourcePath = TempDirectory / (Name + "." + StageExtensions[Stage]);
+    std::filesystem::path SpirvPath = SourcePath;
+    SpirvPath += ".spv";
+
+    {
+        std::ofstream File(SourcePath, std::ios::binary | std::ios::trunc);
+        if (!File || !File.write(Source.data(), Source.size()))
+        {
+            std::cerr << "Failed to write " << SourcePath.string() << "\n";
+            return false;
+        }
+    }
+
+    std::string Command = "\"" + Options.Glslang + "\"";
+    if (Options.Spirv)
+        Command += " -G -o \"" + SpirvPath.string() + "\"";
+
+    Command += " \"" + SourcePath.string() + "\"";
+
+    if (RunCommand(Command) != 0)
+    {
+        std::cerr << Name << ": " << StageNames[Stage] << " stage failed to validate";
+
+        //GL SPIR-V is stricter than the driver's own GLSL compiler
+        if (Options.Spirv)
+            std::cerr << ", SPIR-V needs explicit locations on every uniform outside a block";
+
+        std::cerr << "\n";
+        return false;
+    }
+
+    if (Options.Spirv && !ReadSpirv(SpirvPath, Spirv))
+    {
+        std::cerr << "Failed to read " << SpirvPath.string() << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+static bool CookProgramEntry(const CookOptions& Options, ShaderPreprocessor& Preprocessor, const std::filesystem::path& TempDirectory, const CookProgram& Program, ShaderArchiveEntry& Entry, std::vector<std::string>& Dependencies)
+{
+    if (!ValidateStages(Program))
+        return false;
+
+    Entry.Name = Program.Name;
+    Entry.Separable = Program.Separable;
+
+    bool Success = true;
+
+    for (u32 Stage = 0; Stage < 4; Stage++)
+    {
+        if (Program.Paths[Stage].empty())
+            continue;
+
+        const PreprocessedShader* Shader = Preprocessor.PreprocessFile(Program.Paths[Stage], Program.Defines);
+        if (!Shader)
+        {
+            std::cerr << Program.Name << ": failed to preprocess " << Program.Paths[Stage] << "\n";
+            Success = false;
+            continue;
+        }
+
+        Dependencies.insert(Dependencies.end(), Shader->Files.begin(), Shader->Files.end());
+        Entry.Sources[Stage] = Shader->Source;
+
+        if (!Options.Glslang.empty())
+            Success &= CompileStage(Options, TempDirectory, Program.Name, Stage, Shader->Source, Entry.Spirv[Stage]);
+    }
+
+    return Success;
+}
+
+static bool WriteDepFile(const std::string& Path, const std::string& Target, const std::vector<std::string>& Dependencies)
+{
+    std::ofstream File(Path, std::ios::trunc);
+    if (!File)
+    {
+        std::cerr << "Failed to write dependency file " << Path << "\n";
+        return false;
+    }
+
+    auto Escape = [](const std::string& String)
+    {
+        std::string Escaped;
+        for (char Character : String)
+        {
+            if (Character == ' ') Escaped += '\\';
+            Escaped += Character == '\\' ? '/' : Character;
+        }
+        return Escaped;
+    };
+
+    File << Escape(Target) << ":";
+
+    for (const std::string& Dependency : Dependencies)
+        File << " \\\n  " << Escape(Dependency);
+
+    File << "\n";
+    return true;
+}
+
+int main(int ArgumentCount, char** Arguments)
+{
+    CookOptions Options;
+    if (!ParseArguments(ArgumentCount, Arguments, Options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<CookProgram> Programs;
+    if (!ParseManifest(Options.ManifestPath, Programs))
+        return 1;
+
+    //one directory per output so parallel cooks of different archives don't clean up each other's files
+    char TempName[32];
+    std::snprintf(TempName, sizeof(TempName), "ShaderCook-%016llx", static_cast<unsigned long long>(HashString(Options.OutputPath.c_str())));
+
+    std::error_code Error;
+    std::filesystem::path TempDirectory = std::filesystem::temp_directory_path(Error) / TempName;
+    std::filesystem::create_directories(TempDirectory, Error);
+
+    DiskFileSystem FileSystem(Options.Root);
+    ShaderPreprocessor Preprocessor(FileSystem);
+    ShaderArchive Archive;
+
+    std::vector<std::string> Dependencies = { Options.ManifestPath };
+    bool Success = true;
+
+    //keep going after a failure so one run reports every broken program
+    for (const CookProgram& Program : Programs)
+    {
+        if (Archive.Find(Program.Name))
+        {
+            std::cerr << Options.ManifestPath << "(" << Program.Line << "): " << Program.Name << " is listed twice\n";
+            Success = false;
+            continue;
+        }
+
+        ShaderArchiveEntry Entry;
+        std::vector<std::string> ProgramDependencies;
+
+        if (!CookProgramEntry(Options, Preprocessor, TempDirectory, Program, Entry, ProgramDependencies))
+        {
+            Success = false;
+            continue;
+        }
+
+        for (const std::string& Path : ProgramDependencies)
+            Dependencies.push_back(FileSystem.GetFullPath(Path));
+
+        Archive.Add(std::move(Entry));
+    }
+
+    std::filesystem::remove_all(TempDirectory, Error);
+
+    if (!Success)
+    {
+        std::cerr << "Shader cook failed, " << Options.OutputPath << " was not written\n";
+        return 1;
+    }
+
+    std::sort(Dependencies.begin(), Dependencies.end());
+    Dependencies.erase(std::unique(Dependencies.begin(), Dependencies.end()), Dependencies.end());
+
+    if (!Archive.Save(Options.OutputPath))
+        return 1;
+
+    if (!Options.DepFile.empty() && !WriteDepFile(Options.DepFile, Options.OutputPath, Dependencies))
+        return 1;
+
+    std::cout << "Cooked " << Archive.GetEntries().size() << " programs into " << Options.OutputPath << "\n";
+    return 0;
+}
@@ -3,7 +3,8 @@
 
 int main()
 {
-    Base::Init();
+    if (!Base::Init())
+        return 1;
 
     Base::Destroy();
     return 0;